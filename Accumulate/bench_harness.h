@@ -0,0 +1,125 @@
+// ──────────────────────────── bench_harness.h ──────────────────────────
+// Statistical measurement harness for the sum kernels.  C++20.
+//
+// A single timed run on a shared host is ±30% noise; this harness runs
+// configurable warmup iterations plus N timed repetitions, optionally
+// flushes the cache between runs, and reports p10/median/p90 and GB/s.
+// Output can be human-readable text, CSV or JSON lines, so CI can diff
+// runs mechanically.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+
+namespace bench {
+
+struct options
+{
+	int  warmup      = 2;
+	int  reps        = 9;
+	bool flush_cache = false;      // evict the LLC between timed runs
+	bool counters    = false;      // perf_event readout around the last rep
+
+	enum class output { text, csv, json };
+	output format = output::text;
+};
+
+struct stats
+{
+	double    p10_ms;
+	double    median_ms;
+	double    p90_ms;
+	double    gb_per_s;            // derived from the median
+	long long result;              // last kernel return value (sanity check)
+	perf::counter_group::sample counters; // valid only with options::counters
+};
+
+// Touch a buffer larger than any LLC so timed runs start cache-cold.
+inline void flush_cache()
+{
+	static std::vector<char> junk(64 * 1024 * 1024);
+	for (std::size_t i = 0; i < junk.size(); i += 64) junk[i]++;
+}
+
+inline stats measure(long long (*sum_func)(const std::vector<int>&),
+                     const std::vector<int>& numbers, const options& opt)
+{
+	for (int i = 0; i < opt.warmup; ++i)
+		(void)sum_func(numbers);
+
+	std::vector<double> ms;
+	ms.reserve(opt.reps);
+	long long result = 0;
+
+	perf::counter_group counters;
+	perf::counter_group::sample counter_sample;
+
+	const int reps = std::max(1, opt.reps);
+	for (int i = 0; i < reps; ++i) {
+		if (opt.flush_cache) flush_cache();
+		const bool count_this = opt.counters && i == reps - 1; // last rep only
+		if (count_this) counters.start();
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		result = sum_func(numbers);
+		const auto t2 = std::chrono::high_resolution_clock::now();
+		if (count_this) {
+			counters.stop();
+			counter_sample = counters.read();
+		}
+		ms.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+		             .count() / 1e6);
+	}
+	std::sort(ms.begin(), ms.end());
+
+	auto pct = [&](double p) {
+		return ms[static_cast<std::size_t>(p * (ms.size() - 1) + 0.5)];
+	};
+
+	const double median = pct(0.50);
+	const double gb = numbers.size() * sizeof(int) / (1024.0 * 1024.0 * 1024.0);
+
+	return {pct(0.10), median, pct(0.90),
+	        median > 0 ? gb / (median / 1e3) : 0.0, result, counter_sample};
+}
+
+// One result row in the configured format.  CSV/JSON callers print the
+// header / array brackets themselves (see csv_header below).
+inline void report(const std::string& name, std::size_t n, const stats& s,
+                   const options& opt)
+{
+	switch (opt.format) {
+	case options::output::csv:
+		std::cout << name << ',' << n << ',' << n * sizeof(int) << ','
+		          << s.p10_ms << ',' << s.median_ms << ',' << s.p90_ms << ','
+		          << s.gb_per_s << ',' << s.result << '\n';
+		break;
+	case options::output::json:
+		std::cout << "{\"kernel\":\"" << name << "\",\"n\":" << n
+		          << ",\"bytes\":" << n * sizeof(int)
+		          << ",\"p10_ms\":" << s.p10_ms
+		          << ",\"median_ms\":" << s.median_ms
+		          << ",\"p90_ms\":" << s.p90_ms
+		          << ",\"gb_per_s\":" << s.gb_per_s
+		          << ",\"result\":" << s.result << "}\n";
+		break;
+	case options::output::text:
+		std::cout << " " << name << " : Sum: " << s.result
+		          << "   median " << s.median_ms << " ms"
+		          << "  (p10 " << s.p10_ms << " / p90 " << s.p90_ms << ")   "
+		          << s.gb_per_s << " GB/s" << std::endl;
+		if (opt.counters) perf::print_sample(s.counters, n * sizeof(int));
+		break;
+	}
+}
+
+inline void csv_header()
+{
+	std::cout << "kernel,n,bytes,p10_ms,median_ms,p90_ms,gb_per_s,result\n";
+}
+
+} // namespace bench
+// ────────────────────────────────────────────────────────────────────────
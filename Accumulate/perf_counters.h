@@ -0,0 +1,131 @@
+// ──────────────────────────── perf_counters.h ──────────────────────────
+// Minimal perf_event counter surface for the benchmark harnesses.
+// GNU/Linux only; degrades to "unavailable" when perf_event_open is
+// denied (containers, perf_event_paranoid), so callers can always wrap
+// a measurement and only print what the kernel actually provided.
+//
+// Counters: cycles, instructions, LLC read misses, dTLB read misses,
+// backend-stalled cycles.  Derived: IPC, bytes/cycle, misses per KB.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace perf {
+
+class counter_group
+{
+	enum { kCounters = 5 };
+
+	static constexpr const char* kNames[kCounters] = {
+		"cycles", "instructions", "llc_miss", "dtlb_miss", "stalled_be",
+	};
+
+	int fds_[kCounters] = {-1, -1, -1, -1, -1};
+
+	static int open_counter(std::uint32_t type, std::uint64_t config)
+	{
+		perf_event_attr attr{};
+		attr.size           = sizeof attr;
+		attr.type           = type;
+		attr.config         = config;
+		attr.disabled       = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv     = 1;
+		return static_cast<int>(
+			syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+public:
+	counter_group()
+	{
+		constexpr std::uint64_t llc_read_miss =
+			PERF_COUNT_HW_CACHE_LL |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		constexpr std::uint64_t dtlb_read_miss =
+			PERF_COUNT_HW_CACHE_DTLB |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+		fds_[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		fds_[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		fds_[2] = open_counter(PERF_TYPE_HW_CACHE,  llc_read_miss);
+		fds_[3] = open_counter(PERF_TYPE_HW_CACHE,  dtlb_read_miss);
+		fds_[4] = open_counter(PERF_TYPE_HARDWARE,
+		                       PERF_COUNT_HW_STALLED_CYCLES_BACKEND);
+	}
+
+	~counter_group()
+	{
+		for (int fd : fds_)
+			if (fd >= 0) close(fd);
+	}
+
+	// cycles + instructions are the minimum for useful derived numbers
+	[[nodiscard]] bool available() const noexcept
+	{ return fds_[0] >= 0 && fds_[1] >= 0; }
+
+	void start() noexcept
+	{
+		for (int fd : fds_)
+			if (fd >= 0) {
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+	}
+
+	void stop() noexcept
+	{
+		for (int fd : fds_)
+			if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	struct sample
+	{
+		std::uint64_t cycles = 0, instructions = 0;
+		std::uint64_t llc_miss = 0, dtlb_miss = 0, stalled_be = 0;
+		bool valid = false;
+	};
+
+	[[nodiscard]] sample read() const noexcept
+	{
+		sample s;
+		std::uint64_t* vals[kCounters] = {&s.cycles, &s.instructions,
+		                                  &s.llc_miss, &s.dtlb_miss,
+		                                  &s.stalled_be};
+		for (int i = 0; i < kCounters; ++i)
+			if (fds_[i] >= 0)
+				(void)!::read(fds_[i], vals[i], sizeof(std::uint64_t));
+		s.valid = available();
+		return s;
+	}
+
+	counter_group(const counter_group&)            = delete;
+	counter_group& operator=(const counter_group&) = delete;
+};
+
+// Print derived metrics for one kernel invocation over `bytes` of input.
+inline void print_sample(const counter_group::sample& s, std::size_t bytes)
+{
+	if (!s.valid) {
+		std::cout << "      [perf counters unavailable]\n";
+		return;
+	}
+	const double cyc = static_cast<double>(s.cycles);
+	std::cout << "      IPC " << (cyc > 0 ? s.instructions / cyc : 0.0)
+	          << "   bytes/cycle " << (cyc > 0 ? bytes / cyc : 0.0)
+	          << "   LLC-miss/KB " << (bytes ? s.llc_miss * 1024.0 / bytes : 0.0)
+	          << "   dTLB-miss/KB " << (bytes ? s.dtlb_miss * 1024.0 / bytes : 0.0)
+	          << "   stalled-be% "
+	          << (cyc > 0 ? 100.0 * s.stalled_be / cyc : 0.0) << "\n";
+}
+
+} // namespace perf
+// ────────────────────────────────────────────────────────────────────────
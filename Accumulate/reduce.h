@@ -0,0 +1,284 @@
+// ──────────────────────────── reduce.h ─────────────────────────────────
+// Header-only reduction template library.  GNU/Linux + GCC, C++20.
+//
+// The techniques hand-written into the sum_* kernels (two-accumulator
+// AVX2 loops, widening int32→int64 sums, scalar tails) generalized over
+// element type and operation: reduce<plus_op>(float*) picks the packed-
+// float kernel, reduce<max_op>(int*) picks _mm256_max_epi32, and any
+// (T, Op) pair without a specialized kernel falls back to a scalar loop —
+// no hand-porting of intrinsics per combination.  Kernels live in class
+// specializations (plain member functions, so target("avx2") attributes
+// apply), and the dispatch between SIMD and scalar happens once per
+// process via CPUID.
+//
+// Float reductions re-associate the sum (lane-wise then horizontal), so
+// results can differ from a strict left fold in the last ulps.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <immintrin.h>
+
+namespace simd {
+
+// ---- operation tags -------------------------------------------------------
+
+struct plus_op
+{
+	template<class A, class B>
+	static A apply(A a, B b) { return a + static_cast<A>(b); }
+	template<class A>
+	static A identity() { return A{}; }
+};
+
+struct min_op
+{
+	template<class A, class B>
+	static A apply(A a, B b) { return b < a ? static_cast<A>(b) : a; }
+	template<class A>
+	static A identity() { return std::numeric_limits<A>::max(); }
+};
+
+struct max_op
+{
+	template<class A, class B>
+	static A apply(A a, B b) { return a < b ? static_cast<A>(b) : a; }
+	template<class A>
+	static A identity() { return std::numeric_limits<A>::lowest(); }
+};
+
+// ---- kernels --------------------------------------------------------------
+// Primary template: scalar only (any T/Op combination works, just unvectorized).
+template<class T, class Op>
+struct kernel
+{
+	using acc_t = T;
+
+	static acc_t run_scalar(const T* p, std::size_t n)
+	{
+		acc_t acc = Op::template identity<acc_t>();
+		for (std::size_t i = 0; i < n; ++i) acc = Op::apply(acc, p[i]);
+		return acc;
+	}
+
+	static acc_t run(const T* p, std::size_t n) { return run_scalar(p, n); }
+};
+
+// int32 sum → int64 accumulator (the sum_simd widening trick)
+template<>
+struct kernel<int, plus_op>
+{
+	using acc_t = long long;
+
+	static acc_t run_scalar(const int* p, std::size_t n)
+	{
+		acc_t acc = 0;
+		for (std::size_t i = 0; i < n; ++i) acc += p[i];
+		return acc;
+	}
+
+	__attribute__((target("avx2")))
+	static acc_t run(const int* p, std::size_t n)
+	{
+		__m256i acc_lo = _mm256_setzero_si256();
+		__m256i acc_hi = _mm256_setzero_si256();
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+			acc_lo = _mm256_add_epi64(acc_lo,
+				_mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+			acc_hi = _mm256_add_epi64(acc_hi,
+				_mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+		}
+		alignas(32) long long tmp[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(tmp),
+		                   _mm256_add_epi64(acc_lo, acc_hi));
+		acc_t acc = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+		for (; i < n; ++i) acc += p[i];
+		return acc;
+	}
+};
+
+// int64 sum
+template<>
+struct kernel<long long, plus_op>
+{
+	using acc_t = long long;
+
+	static acc_t run_scalar(const long long* p, std::size_t n)
+	{
+		acc_t acc = 0;
+		for (std::size_t i = 0; i < n; ++i) acc += p[i];
+		return acc;
+	}
+
+	__attribute__((target("avx2")))
+	static acc_t run(const long long* p, std::size_t n)
+	{
+		__m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			a0 = _mm256_add_epi64(a0,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+			a1 = _mm256_add_epi64(a1,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 4)));
+		}
+		alignas(32) long long tmp[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(tmp), _mm256_add_epi64(a0, a1));
+		acc_t acc = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+		for (; i < n; ++i) acc += p[i];
+		return acc;
+	}
+};
+
+// float / double sums (re-associated; see header comment)
+template<>
+struct kernel<float, plus_op>
+{
+	using acc_t = float;
+
+	static acc_t run_scalar(const float* p, std::size_t n)
+	{
+		acc_t acc = 0.0f;
+		for (std::size_t i = 0; i < n; ++i) acc += p[i];
+		return acc;
+	}
+
+	__attribute__((target("avx2")))
+	static acc_t run(const float* p, std::size_t n)
+	{
+		__m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			a0 = _mm256_add_ps(a0, _mm256_loadu_ps(p + i));
+			a1 = _mm256_add_ps(a1, _mm256_loadu_ps(p + i + 8));
+		}
+		alignas(32) float tmp[8];
+		_mm256_store_ps(tmp, _mm256_add_ps(a0, a1));
+		acc_t acc = 0.0f;
+		for (float f : tmp) acc += f;
+		for (; i < n; ++i) acc += p[i];
+		return acc;
+	}
+};
+
+template<>
+struct kernel<double, plus_op>
+{
+	using acc_t = double;
+
+	static acc_t run_scalar(const double* p, std::size_t n)
+	{
+		acc_t acc = 0.0;
+		for (std::size_t i = 0; i < n; ++i) acc += p[i];
+		return acc;
+	}
+
+	__attribute__((target("avx2")))
+	static acc_t run(const double* p, std::size_t n)
+	{
+		__m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+			a1 = _mm256_add_pd(a1, _mm256_loadu_pd(p + i + 4));
+		}
+		alignas(32) double tmp[4];
+		_mm256_store_pd(tmp, _mm256_add_pd(a0, a1));
+		acc_t acc = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+		for (; i < n; ++i) acc += p[i];
+		return acc;
+	}
+};
+
+// int32 min/max via a shared lane-wise helper
+template<class Op>
+struct kernel_int_minmax
+{
+	using acc_t = int;
+
+	static acc_t run_scalar(const int* p, std::size_t n)
+	{
+		acc_t acc = Op::template identity<int>();
+		for (std::size_t i = 0; i < n; ++i) acc = Op::apply(acc, p[i]);
+		return acc;
+	}
+
+	__attribute__((target("avx2")))
+	static acc_t run(const int* p, std::size_t n)
+	{
+		constexpr bool is_max = std::is_same_v<Op, max_op>;
+		__m256i acc = _mm256_set1_epi32(Op::template identity<int>());
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+			acc = is_max ? _mm256_max_epi32(acc, v) : _mm256_min_epi32(acc, v);
+		}
+		alignas(32) int tmp[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(tmp), acc);
+		acc_t out = Op::template identity<int>();
+		for (int v : tmp) out = Op::apply(out, v);
+		for (; i < n; ++i) out = Op::apply(out, p[i]);
+		return out;
+	}
+};
+template<> struct kernel<int, min_op> : kernel_int_minmax<min_op> {};
+template<> struct kernel<int, max_op> : kernel_int_minmax<max_op> {};
+
+// ---- generic entry points -------------------------------------------------
+
+[[nodiscard]] inline bool have_avx2()
+{
+	static const bool ok = __builtin_cpu_supports("avx2");
+	return ok;
+}
+
+template<class Op, class T>
+[[nodiscard]] typename kernel<T, Op>::acc_t reduce(const T* p, std::size_t n)
+{
+	return have_avx2() ? kernel<T, Op>::run(p, n)
+	                   : kernel<T, Op>::run_scalar(p, n);
+}
+
+template<class Op, class T>
+[[nodiscard]] typename kernel<T, Op>::acc_t reduce(const std::vector<T>& v)
+{
+	return reduce<Op>(v.data(), v.size());
+}
+
+// ---- dot product (the one op that genuinely wants FMA) --------------------
+
+[[nodiscard]] inline float dot_scalar(const float* a, const float* b, std::size_t n)
+{
+	float acc = 0.0f;
+	for (std::size_t i = 0; i < n; ++i) acc += a[i] * b[i];
+	return acc;
+}
+
+__attribute__((target("avx2,fma")))
+[[nodiscard]] inline float dot_fma(const float* a, const float* b, std::size_t n)
+{
+	__m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+	std::size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		a0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),     _mm256_loadu_ps(b + i),     a0);
+		a1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), a1);
+	}
+	alignas(32) float tmp[8];
+	_mm256_store_ps(tmp, _mm256_add_ps(a0, a1));
+	float acc = 0.0f;
+	for (float f : tmp) acc += f;
+	for (; i < n; ++i) acc += a[i] * b[i];
+	return acc;
+}
+
+[[nodiscard]] inline float dot(const float* a, const float* b, std::size_t n)
+{
+	static const bool fma = __builtin_cpu_supports("fma");
+	return (fma && have_avx2()) ? dot_fma(a, b, n) : dot_scalar(a, b, n);
+}
+
+} // namespace simd
+// ────────────────────────────────────────────────────────────────────────
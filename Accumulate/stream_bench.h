@@ -0,0 +1,179 @@
+// ──────────────────────────── stream_bench.h ───────────────────────────
+// Streaming chunk sources for the sum benchmark.  GNU/Linux + GCC, C++20.
+//
+// The classic harness commits one giant vector up front (~40 GB for the
+// default size), which takes tens of seconds to fault in and OOMs smaller
+// lab machines.  These sources instead feed the kernels one chunk at a
+// time — either a sliding mmap window over a pre-generated data file or a
+// single synthesized chunk replayed until a target volume is reached — so
+// RSS stays bounded by the chunk size and the number measured is sustained
+// processing bandwidth, not first-touch page-fault cost.
+#pragma once
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stream {
+
+struct chunk
+{
+	const int*  data;
+	std::size_t count;      // elements, not bytes
+};
+
+// ---- mmap window over a pre-generated data file ---------------------------
+class file_source
+{
+public:
+	file_source(const std::string& path, std::size_t chunk_bytes)
+		: chunk_bytes_(chunk_bytes)
+	{
+		fd_ = ::open(path.c_str(), O_RDONLY);
+		if (fd_ < 0) return;
+		struct stat st{};
+		if (::fstat(fd_, &st) != 0 || st.st_size == 0) return;
+		bytes_ = static_cast<std::size_t>(st.st_size) / sizeof(int) * sizeof(int);
+		void* p = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (p == MAP_FAILED) return;
+		base_ = static_cast<const int*>(p);
+		(void)::madvise(const_cast<int*>(base_), bytes_, MADV_SEQUENTIAL);
+	}
+
+	~file_source()
+	{
+		if (base_) ::munmap(const_cast<int*>(base_), bytes_);
+		if (fd_ >= 0) ::close(fd_);
+	}
+
+	[[nodiscard]] bool ok() const noexcept { return base_ != nullptr; }
+	[[nodiscard]] std::size_t total_bytes() const noexcept { return bytes_; }
+
+	void rewind() noexcept { offset_ = 0; }
+
+	bool next(chunk& out) noexcept
+	{
+		if (offset_ >= bytes_) return false;
+
+		// Drop the pages we just streamed past so RSS stays ~one chunk.
+		if (offset_ > 0)
+			(void)::madvise(const_cast<int*>(base_), offset_, MADV_DONTNEED);
+
+		const std::size_t len = std::min(chunk_bytes_, bytes_ - offset_);
+		out.data  = base_ + offset_ / sizeof(int);
+		out.count = len / sizeof(int);
+		offset_  += len;
+		return true;
+	}
+
+	file_source(const file_source&)            = delete;
+	file_source& operator=(const file_source&) = delete;
+
+private:
+	int         fd_{-1};
+	const int*  base_{nullptr};
+	std::size_t bytes_{0};
+	std::size_t offset_{0};
+	std::size_t chunk_bytes_;
+};
+
+// ---- synthesized chunks (no file, no large allocation) --------------------
+// Fills the caller's buffer once, then replays it until total_bytes worth of
+// data has been handed out — the cheapest way to benchmark at 100 GB+ scale.
+class synth_source
+{
+public:
+	synth_source(std::size_t total_bytes, std::size_t chunk_bytes,
+	             std::vector<int>& buffer, int fill_value = 3)
+		: buffer_(buffer)
+	{
+		buffer_.assign(chunk_bytes / sizeof(int), fill_value);
+		if (buffer_.empty()) return;      // chunk below one element: ok() false
+		// Whole chunks only, so the buffer is handed out as-is every time.
+		const std::size_t bytes = buffer_.size() * sizeof(int);
+		total_bytes_ = std::max(bytes, total_bytes / bytes * bytes);
+	}
+
+	[[nodiscard]] bool ok() const noexcept { return !buffer_.empty(); }
+	[[nodiscard]] std::size_t total_bytes() const noexcept { return total_bytes_; }
+
+	void rewind() noexcept { offset_ = 0; }
+
+	bool next(chunk& out) noexcept
+	{
+		if (offset_ >= total_bytes_) return false;
+		const std::size_t len =
+			std::min(buffer_.size() * sizeof(int), total_bytes_ - offset_);
+		out.data  = buffer_.data();
+		out.count = len / sizeof(int);
+		offset_  += len;
+		return true;
+	}
+
+private:
+	std::vector<int>& buffer_;
+	std::size_t       total_bytes_{0};
+	std::size_t       offset_{0};
+};
+
+// ---- generator for file_source inputs -------------------------------------
+inline bool write_test_file(const std::string& path, std::size_t gigabytes,
+                            int fill_value = 3)
+{
+	std::vector<int> block(16 * 1024 * 1024 / sizeof(int), fill_value);
+	int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) return false;
+	std::size_t remaining = gigabytes << 30;
+	while (remaining > 0) {
+		const std::size_t len = std::min(remaining, block.size() * sizeof(int));
+		if (::write(fd, block.data(), len) != static_cast<ssize_t>(len)) {
+			::close(fd);
+			return false;
+		}
+		remaining -= len;
+	}
+	::close(fd);
+	return true;
+}
+
+// ---- harness --------------------------------------------------------------
+// Feeds every chunk of the source through sum_func and reports sustained
+// bandwidth.  Chunks that are not already the scratch buffer (file_source)
+// are copied into it, since the kernels take a std::vector — the copy
+// streams at memory bandwidth and keeps the measurement honest enough.
+template<class Source>
+void run_kernel(const char* name, long long (*sum_func)(const std::vector<int>&),
+                Source& source, std::vector<int>& scratch)
+{
+	source.rewind();
+
+	long long   total = 0;
+	std::size_t bytes = 0;
+	chunk       c{};
+
+	const auto t1 = std::chrono::high_resolution_clock::now();
+	while (source.next(c)) {
+		if (c.data != scratch.data())
+			scratch.assign(c.data, c.data + c.count);
+		total += sum_func(scratch);
+		bytes += c.count * sizeof(int);
+	}
+	const auto t2 = std::chrono::high_resolution_clock::now();
+
+	const double secs =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+	const double gb = bytes / (1024.0 * 1024.0 * 1024.0);
+
+	std::cout << " " << name << " : Sum: " << total
+	          << "   " << gb << " GB in " << secs << " s   ("
+	          << (secs > 0 ? gb / secs : 0.0) << " GB/s)" << std::endl;
+}
+
+} // namespace stream
+// ────────────────────────────────────────────────────────────────────────
@@ -0,0 +1,190 @@
+// ──────────────────────────── thread_pool.h ────────────────────────────
+// Persistent work-stealing thread pool with a reduce(range, init, op) API.
+// GNU/Linux + GCC, C++20.
+//
+// sum_parallel_jthread / sum_async_hw pay a full thread-spawn per call;
+// for services doing thousands of small reductions per second that spawn
+// cost dominates.  This pool is created once (or shared via instance()),
+// keeps its workers parked on a condition variable, and splits each
+// reduction into chunks that idle workers steal from each other's deques —
+// so repeated small reductions amortize thread startup to zero.
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "numa_reduce.h"   // numa::padded — cache-line padded partials
+
+namespace pool {
+
+class thread_pool
+{
+public:
+	explicit thread_pool(unsigned num_threads = std::thread::hardware_concurrency())
+	{
+		if (num_threads == 0) num_threads = 1;
+		queues_.reserve(num_threads);
+		for (unsigned i = 0; i < num_threads; ++i)
+			queues_.push_back(std::make_unique<worker_queue>());
+		workers_.reserve(num_threads);
+		for (unsigned i = 0; i < num_threads; ++i)
+			workers_.emplace_back([this, i] { worker_loop(i); });
+	}
+
+	~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			stop_ = true;
+		}
+		sleep_cv_.notify_all();
+	}
+
+	// Shared warm pool, constructed on first use and reused for the rest of
+	// the process lifetime.
+	static thread_pool& instance()
+	{
+		static thread_pool shared;
+		return shared;
+	}
+
+	[[nodiscard]] unsigned size() const noexcept
+	{ return static_cast<unsigned>(workers_.size()); }
+
+	// ----------------------------------------------- REDUCE --------------
+	// Reduce [first, last) with op : T × T → T (elements converted to T).
+	// The range is cut into ~4 chunks per worker (never below kMinChunk
+	// elements) so stealing can balance load without drowning in tasks.
+	template<class It, class T, class Op>
+	[[nodiscard]] T reduce(It first, It last, T init, Op op)
+	{
+		static constexpr std::size_t kMinChunk = 16 * 1024;
+
+		const std::size_t n = static_cast<std::size_t>(last - first);
+		if (n <= kMinChunk) {                       // not worth dispatching
+			T local = init;
+			for (It it = first; it != last; ++it)
+				local = op(local, static_cast<T>(*it));
+			return local;
+		}
+
+		const std::size_t chunk = std::max(kMinChunk, n / (size() * 4));
+		const std::size_t num_chunks = (n + chunk - 1) / chunk;
+
+		std::vector<numa::padded<T>> partials(num_chunks, numa::padded<T>{T{}});
+		std::size_t                  remaining = num_chunks; // guarded by done_mutex
+		std::mutex                   done_mutex;
+		std::condition_variable      done_cv;
+
+		for (std::size_t c = 0; c < num_chunks; ++c) {
+			const std::size_t begin = c * chunk;
+			const std::size_t end   = std::min(begin + chunk, n);
+			submit([first, begin, end, c, op, &partials, &remaining,
+			        &done_mutex, &done_cv] {
+				// Seed from the chunk's first element — T{} is only op's
+				// identity for sums (chunks are never empty).
+				T local = static_cast<T>(*(first + begin));
+				for (It it = first + begin + 1; it != first + end; ++it)
+					local = op(local, static_cast<T>(*it));
+				partials[c].value = local;
+				// Decrement and notify under the lock: a waiter must not be
+				// able to observe zero and destroy these locals while this
+				// task still holds references to them.
+				std::lock_guard<std::mutex> lock(done_mutex);
+				if (--remaining == 0) done_cv.notify_one();
+			});
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(done_mutex);
+			done_cv.wait(lock, [&] { return remaining == 0; });
+		}
+
+		T total = init;
+		for (std::size_t c = 0; c < num_chunks; ++c)
+			total = op(total, partials[c].value);
+		return total;
+	}
+
+	thread_pool(const thread_pool&)            = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+private:
+	using task = std::function<void()>;
+
+	// One deque per worker, each on its own cache line: the owner pops from
+	// the front, thieves pop from the back.
+	struct alignas(64) worker_queue
+	{
+		std::mutex       mutex;
+		std::deque<task> tasks;
+	};
+
+	std::vector<std::unique_ptr<worker_queue>> queues_;
+	std::vector<std::jthread>                  workers_;
+	std::mutex                                 sleep_mutex_;
+	std::condition_variable                    sleep_cv_;
+	std::atomic<unsigned>                      next_queue_{0};
+	std::atomic<unsigned>                      pending_{0};
+	bool                                       stop_{false};
+
+	void submit(task t)
+	{
+		const unsigned q = next_queue_.fetch_add(1, std::memory_order_relaxed)
+		                   % queues_.size();
+		{
+			std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+			queues_[q]->tasks.push_back(std::move(t));
+		}
+		{
+			// Publish under sleep_mutex_, like the destructor does with
+			// stop_: a worker that just saw pending_ == 0 in the predicate
+			// but hasn't blocked yet would otherwise miss this notify (lost
+			// wakeup → the chunk never runs and reduce() hangs).
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			pending_.fetch_add(1, std::memory_order_release);
+		}
+		sleep_cv_.notify_one();
+	}
+
+	bool try_pop(unsigned q, task& out, bool steal)
+	{
+		std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+		auto& d = queues_[q]->tasks;
+		if (d.empty()) return false;
+		if (steal) { out = std::move(d.back());  d.pop_back(); }
+		else       { out = std::move(d.front()); d.pop_front(); }
+		return true;
+	}
+
+	void worker_loop(unsigned self)
+	{
+		for (;;) {
+			task t;
+			bool got = try_pop(self, t, /*steal=*/false);
+			for (unsigned i = 1; !got && i < queues_.size(); ++i)
+				got = try_pop((self + i) % queues_.size(), t, /*steal=*/true);
+
+			if (got) {
+				pending_.fetch_sub(1, std::memory_order_relaxed);
+				t();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleep_mutex_);
+			sleep_cv_.wait(lock, [this] {
+				return stop_ || pending_.load(std::memory_order_acquire) != 0;
+			});
+			if (stop_) return;
+		}
+	}
+};
+
+} // namespace pool
+// ────────────────────────────────────────────────────────────────────────
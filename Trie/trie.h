@@ -1,15 +1,182 @@
 // ──────────────────────────── trie_pool.hpp ────────────────────────────
 #pragma once
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <span>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <utility>
 #include <limits>
 #include <cassert>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace fast {
 
+/* -----------------------------------------------------------
+ *  snapshot format (version 1)
+ * -----------------------------------------------------------
+ *  header | Node[n] | flat_bitmap[b] | uint32 dense[d] | T[v]
+ *  Sections are written raw (host endianness); values must be
+ *  trivially copyable.  checksum is FNV-1a64 over the payload
+ *  so torn snapshots can be detected (verification is explicit
+ *  — it faults every page, which an mmap load wants to avoid).
+ * ----------------------------------------------------------*/
+namespace snapshot {
+
+    inline constexpr char          magic[8] = {'P','T','R','I','E','v','1','\0'};
+    inline constexpr std::uint32_t version  = 1;
+
+    struct header
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t node_size;
+        std::uint32_t value_size;
+        std::uint32_t reserved;
+        std::uint64_t node_count;
+        std::uint64_t bitmap_count;
+        std::uint64_t dense_count;
+        std::uint64_t value_count;
+        std::uint64_t checksum;
+    };
+
+    // BitmapNode with its dense children flattened into the shared array.
+    struct flat_bitmap
+    {
+        std::uint64_t bits[4];
+        std::uint32_t dense_off;
+        std::uint32_t dense_len;
+    };
+
+    [[nodiscard]] inline std::uint64_t
+    fnv1a(const void* data, std::size_t len,
+          std::uint64_t h = 14695981039346656037ull) noexcept
+    {
+        auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < len; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+} // namespace snapshot
+
+/* -----------------------------------------------------------
+ *  slab_vector  –  slab-chained arena storage for the tries
+ * -----------------------------------------------------------
+ *  Vector substitute that grows by chaining fixed 2 MiB slabs
+ *  (aligned, madvise(MADV_HUGEPAGE) best-effort) instead of
+ *  reallocate-and-copy: a multi-GB arena never stalls mid-
+ *  serving copying itself, keeps uint32_t index addressing,
+ *  and sits on hugepages where the kernel allows — dTLB walks
+ *  drop accordingly.  Implements exactly the surface pool_trie
+ *  needs; T must be default-constructible (slabs construct
+ *  whole).  Select it via pool_trie's Storage parameter (see
+ *  hugepage_pool_trie below).
+ * ----------------------------------------------------------*/
+template<class T, class... /*vector-signature compat*/>
+class slab_vector
+{
+    static constexpr std::size_t kSlabBytes = std::size_t(2) << 20;   // 2 MiB
+    static_assert(sizeof(T) <= kSlabBytes, "element larger than a slab");
+    static constexpr std::size_t kPerSlab = kSlabBytes / sizeof(T);
+
+    std::vector<T*> slabs_;
+    std::size_t     size_ {0};
+
+    static T* alloc_slab()
+    {
+        void* p = std::aligned_alloc(kSlabBytes, kSlabBytes);
+        if (!p) throw std::bad_alloc();
+        (void)madvise(p, kSlabBytes, MADV_HUGEPAGE);    // best effort
+        T* t = static_cast<T*>(p);
+        for (std::size_t i = 0; i < kPerSlab; ++i) new (t + i) T();
+        return t;
+    }
+
+    void destroy() noexcept
+    {
+        for (T* s : slabs_) {
+            for (std::size_t i = 0; i < kPerSlab; ++i) s[i].~T();
+            std::free(s);
+        }
+        slabs_.clear();
+        size_ = 0;
+    }
+
+public:
+    slab_vector() = default;
+    ~slab_vector() { destroy(); }
+
+    slab_vector(slab_vector&& o) noexcept
+        : slabs_(std::move(o.slabs_)), size_(o.size_)
+    { o.slabs_.clear(); o.size_ = 0; }
+
+    slab_vector& operator=(slab_vector&& o) noexcept
+    {
+        if (this != &o) {
+            destroy();
+            slabs_ = std::move(o.slabs_);
+            size_  = o.size_;
+            o.slabs_.clear();
+            o.size_ = 0;
+        }
+        return *this;
+    }
+
+    slab_vector(const slab_vector&)            = delete;
+    slab_vector& operator=(const slab_vector&) = delete;
+
+    [[nodiscard]] std::size_t size()  const noexcept { return size_; }
+    [[nodiscard]] bool        empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] T& operator[](std::size_t i) noexcept
+    { return slabs_[i / kPerSlab][i % kPerSlab]; }
+    [[nodiscard]] const T& operator[](std::size_t i) const noexcept
+    { return slabs_[i / kPerSlab][i % kPerSlab]; }
+
+    [[nodiscard]] T&       back() noexcept       { return (*this)[size_ - 1]; }
+    [[nodiscard]] const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    void reserve(std::size_t n)
+    {
+        while (slabs_.size() * kPerSlab < n) slabs_.push_back(alloc_slab());
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (size_ == slabs_.size() * kPerSlab) slabs_.push_back(alloc_slab());
+        T& slot = (*this)[size_++];
+        slot = T(std::forward<Args>(args)...);
+        return slot;
+    }
+    void push_back(const T& v) { emplace_back(v); }
+    void push_back(T&& v)      { emplace_back(std::move(v)); }
+
+    // Contiguous spans, slab by slab (snapshot writing / checksumming).
+    template<class F>
+    void for_each_span(F&& f) const
+    {
+        for (std::size_t i = 0; i < slabs_.size() && i * kPerSlab < size_; ++i)
+            f(static_cast<const T*>(slabs_[i]),
+              std::min(kPerSlab, size_ - i * kPerSlab));
+    }
+};
+
 /* -----------------------------------------------------------
  *  pool_trie  –  compact radix‑tree with pooled values
  * -----------------------------------------------------------
@@ -19,8 +186,21 @@ namespace fast {
  *  • Node storage   : contiguous pool  (std::vector<Node>)
  *  • Complexity     : O(|key|) for insert / lookup
  *  • Memory / node  : 16 bytes (aligned)  ➜  ~1.2 MiB per 75 000 nodes
+ *
+ *  Nodes whose fan-out exceeds kBitmapThreshold are promoted to an
+ *  adaptive representation: a 256-bit label bitmap plus a dense child
+ *  array indexed by popcount.  Lookup through such a node is one bit
+ *  test + one rank instead of a walk over dozens of linked siblings —
+ *  which is what the hot top levels of URL-style keyspaces look like.
+ *  Sparse nodes keep the compact linked-sibling form.
+ *
+ *  Storage selects the arena container behind nodes_ and
+ *  value_pool_: std::vector (default; contiguous, cheapest) or
+ *  slab_vector (hugepage-backed, copy-free growth) — indexes
+ *  stay uint32_t either way.
  * ----------------------------------------------------------*/
-template<class T, class CharT = char>
+template<class T, class CharT = char,
+         template<class...> class Storage = std::vector>
 class pool_trie
 {
     static_assert(sizeof(CharT) == 1,
@@ -39,8 +219,27 @@ class pool_trie
         [[nodiscard]] bool has_value() const noexcept { return value_idx != npos; }
     };
 
-    std::vector<Node> nodes_;     // node arena  (root is node 0)
-    std::vector<T>    value_pool_;// value arena (dense)
+    // High-fan-out child table: bit c set ⇔ child with label c exists, and
+    // its node index lives at dense[rank(c)] (children sorted by label).
+    struct BitmapNode
+    {
+        std::uint64_t              bits[4] {};
+        std::vector<std::uint32_t> dense;
+    };
+
+    // A first_child with the tag bit set indexes bitmap_nodes_ instead of
+    // nodes_ (halves the node index space to 2 Gi — plenty).
+    static constexpr std::uint32_t bitmap_tag = 0x8000'0000u;
+
+    // Fan-out at which a sibling list is promoted to a BitmapNode.
+    static constexpr std::uint32_t kBitmapThreshold = 8;
+
+    [[nodiscard]] static bool is_bitmap(std::uint32_t head) noexcept
+    { return head != npos && (head & bitmap_tag); }
+
+    Storage<Node>           nodes_;       // node arena  (root is node 0)
+    std::vector<BitmapNode> bitmap_nodes_;// promoted child tables
+    Storage<T>              value_pool_;  // value arena (dense)
 
     // ---- low‑level helpers ---------------------------------------------
     [[nodiscard]] std::uint32_t make_node(CharT lbl) {
@@ -49,34 +248,112 @@ class pool_trie
         return static_cast<std::uint32_t>(nodes_.size() - 1);
     }
 
+    // Number of dense entries in front of label c (popcount over lower bits)
+    [[nodiscard]] static std::uint32_t bitmap_rank(const BitmapNode& b, unsigned c) noexcept {
+        std::uint32_t rank = 0;
+        for (unsigned w = 0; w < (c >> 6); ++w)
+            rank += static_cast<std::uint32_t>(std::popcount(b.bits[w]));
+        const std::uint64_t below = (c & 63) ? (std::uint64_t(1) << (c & 63)) - 1 : 0;
+        rank += static_cast<std::uint32_t>(std::popcount(b.bits[c >> 6] & below));
+        return rank;
+    }
+
+    [[nodiscard]] static bool bitmap_test(const BitmapNode& b, unsigned c) noexcept
+    { return (b.bits[c >> 6] >> (c & 63)) & 1; }
+
     // Return child with given label or npos
     [[nodiscard]] std::uint32_t find_child(std::uint32_t parent, CharT lbl) const noexcept {
-        for (auto c = nodes_[parent].first_child;
-             c != npos;
-             c = nodes_[c].next_sibling)
-        {
-            if (nodes_[c].label == lbl) return c;
+        const std::uint32_t head = nodes_[parent].first_child;
+
+        if (is_bitmap(head)) {                        // O(1): bit test + rank
+            const BitmapNode& b = bitmap_nodes_[head & ~bitmap_tag];
+            const unsigned    c = static_cast<unsigned char>(lbl);
+            if (!bitmap_test(b, c)) return npos;
+            return b.dense[bitmap_rank(b, c)];
         }
+
+        for (auto c = head; c != npos; c = nodes_[c].next_sibling)
+            if (nodes_[c].label == lbl) return c;
         return npos;
     }
 
-    // Insert child in *sorted* sibling list, return its index
+    // Turn parent's sorted sibling list into a BitmapNode child table.
+    void promote_to_bitmap(std::uint32_t parent) {
+        BitmapNode b;
+        for (auto c = nodes_[parent].first_child; c != npos; ) {
+            const unsigned lbl = static_cast<unsigned char>(nodes_[c].label);
+            b.bits[lbl >> 6] |= std::uint64_t(1) << (lbl & 63);
+            b.dense.push_back(c);                     // list is sorted → dense too
+            const auto next = nodes_[c].next_sibling;
+            nodes_[c].next_sibling = npos;            // no longer chained
+            c = next;
+        }
+        bitmap_nodes_.push_back(std::move(b));
+        nodes_[parent].first_child =
+            bitmap_tag | static_cast<std::uint32_t>(bitmap_nodes_.size() - 1);
+    }
+
+    // Insert child (sorted sibling list or bitmap table), return its index
     [[nodiscard]] std::uint32_t emplace_child(std::uint32_t parent, CharT lbl) {
-        auto& p = nodes_[parent];
-        std::uint32_t* link = &p.first_child;
+        const std::uint32_t head = nodes_[parent].first_child;
+
+        if (is_bitmap(head)) {
+            const unsigned c = static_cast<unsigned char>(lbl);
+            {
+                const BitmapNode& b = bitmap_nodes_[head & ~bitmap_tag];
+                if (bitmap_test(b, c)) return b.dense[bitmap_rank(b, c)];
+            }
+            const std::uint32_t new_idx = make_node(lbl);
+            BitmapNode& b = bitmap_nodes_[head & ~bitmap_tag];
+            b.bits[c >> 6] |= std::uint64_t(1) << (c & 63);
+            b.dense.insert(b.dense.begin() + bitmap_rank(b, c), new_idx);
+            return new_idx;
+        }
 
         // keep siblings sorted → accelerates lookup slightly
-        while (*link != npos && nodes_[*link].label < lbl)
-            link = &nodes_[*link].next_sibling;
+        std::uint32_t prev = npos, cur = head, fan_out = 0;
+        while (cur != npos && nodes_[cur].label < lbl) {
+            prev = cur;
+            cur  = nodes_[cur].next_sibling;
+            ++fan_out;
+        }
+        if (cur != npos && nodes_[cur].label == lbl) return cur; // already exists
+        for (auto s = cur; s != npos; s = nodes_[s].next_sibling) ++fan_out;
 
-        if (*link != npos && nodes_[*link].label == lbl) return *link; // already exists
+        const std::uint32_t new_idx = make_node(lbl);  // may reallocate nodes_
+        nodes_[new_idx].next_sibling = cur;
+        if (prev == npos) nodes_[parent].first_child = new_idx;
+        else              nodes_[prev].next_sibling  = new_idx;
 
-        const std::uint32_t new_idx = make_node(lbl);
-        nodes_[new_idx].next_sibling = *link;
-        *link = new_idx;
+        if (fan_out + 1 > kBitmapThreshold) promote_to_bitmap(parent);
         return new_idx;
     }
 
+    // Visit children in label order, whatever the representation.
+    template<class F>
+    void for_each_child(std::uint32_t parent, F&& f) const
+    {
+        const std::uint32_t head = nodes_[parent].first_child;
+        if (is_bitmap(head)) {
+            for (auto c : bitmap_nodes_[head & ~bitmap_tag].dense) f(c);
+        } else {
+            for (auto c = head; c != npos; c = nodes_[c].next_sibling) f(c);
+        }
+    }
+
+    // Depth-first enumeration for visit_prefix (depth ≤ 64 by key guard).
+    template<class F>
+    void visit_subtree(std::uint32_t node, CharT* buf, std::size_t len, F& cb) const
+    {
+        if (nodes_[node].has_value())
+            cb(std::basic_string_view<CharT>(buf, len),
+               value_pool_[nodes_[node].value_idx]);
+        for_each_child(node, [&](std::uint32_t c) {
+            buf[len] = nodes_[c].label;
+            visit_subtree(c, buf, len + 1, cb);
+        });
+    }
+
 public:
     pool_trie()             { nodes_.reserve(256);  nodes_.push_back(Node{}); /*root*/ }
     explicit pool_trie(std::size_t node_cap, std::size_t val_cap = 0)
@@ -85,6 +362,75 @@ public:
         nodes_.push_back(Node{});
     }
 
+    // Bulk-load from a sorted (key, value) range and freeze() immediately:
+    // the resulting trie has the read-optimized BFS layout from the start.
+    template<class It>
+    pool_trie(It first, It last) : pool_trie()
+    {
+        for (It it = first; it != last; ++it)
+            insert(std::basic_string_view<CharT>(it->first), it->second);
+        freeze();
+    }
+
+    // --------------------------------------------------- FREEZE ----------
+    // Re-linearize the node pool into BFS order with each node's children
+    // stored contiguously (label-sorted).  Insertion order scatters sibling
+    // nodes across the whole pool; after freeze() a lookup's next hop is
+    // usually on the same or a neighbouring cacheline.  Values stay put.
+    // The trie remains fully usable (inserts simply un-optimize the layout
+    // locally).
+    void freeze()
+    {
+        Storage<Node>              out;
+        std::vector<BitmapNode>    out_bitmaps;
+        std::vector<std::uint32_t> order;          // old index at each new slot
+        out.reserve(nodes_.size());
+        order.reserve(nodes_.size());
+
+        order.push_back(0);
+        out.push_back(nodes_[0]);
+
+        for (std::uint32_t pos = 0; pos < out.size(); ++pos) {
+            const Node& old = nodes_[order[pos]];
+
+            // children in label order, regardless of representation
+            std::vector<std::uint32_t> kids;
+            if (is_bitmap(old.first_child)) {
+                kids = bitmap_nodes_[old.first_child & ~bitmap_tag].dense;
+            } else {
+                for (auto c = old.first_child; c != npos; c = nodes_[c].next_sibling)
+                    kids.push_back(c);
+            }
+
+            const auto base = static_cast<std::uint32_t>(out.size());
+            for (std::size_t k = 0; k < kids.size(); ++k) {
+                order.push_back(kids[k]);
+                out.push_back(nodes_[kids[k]]);
+                out.back().next_sibling = (k + 1 < kids.size())
+                                            ? base + static_cast<std::uint32_t>(k) + 1
+                                            : npos;
+            }
+
+            if (is_bitmap(old.first_child)) {
+                BitmapNode b;
+                std::copy(std::begin(bitmap_nodes_[old.first_child & ~bitmap_tag].bits),
+                          std::end(bitmap_nodes_[old.first_child & ~bitmap_tag].bits),
+                          std::begin(b.bits));
+                b.dense.resize(kids.size());
+                for (std::size_t k = 0; k < kids.size(); ++k)
+                    b.dense[k] = base + static_cast<std::uint32_t>(k);
+                out_bitmaps.push_back(std::move(b));
+                out[pos].first_child =
+                    bitmap_tag | static_cast<std::uint32_t>(out_bitmaps.size() - 1);
+            } else {
+                out[pos].first_child = kids.empty() ? npos : base;
+            }
+        }
+
+        nodes_        = std::move(out);
+        bitmap_nodes_ = std::move(out_bitmaps);
+    }
+
     // --------------------------------------------------- INSERT ----------
     template<class U>
     T& insert(std::basic_string_view<CharT> key, U&& val)
@@ -117,10 +463,173 @@ public:
     [[nodiscard]] const T* find(std::basic_string_view<CharT> key) const noexcept
     { return const_cast<pool_trie*>(this)->find(key); }
 
+    // --------------------------------------------------- FIND (BATCH) ----
+    // Resolve many keys at once: the traversals are interleaved one level
+    // per round, and each key's next node is software-prefetched while the
+    // other lookups execute, so the dependent cache-miss chains overlap
+    // instead of serializing.  out[i] receives find(keys[i]).
+    void find_batch(std::span<const std::basic_string_view<CharT>> keys,
+                    std::span<T*> out) noexcept
+    {
+        assert(out.size() >= keys.size());
+
+        struct State { std::uint32_t node; std::uint32_t pos; };
+        std::vector<State> st(keys.size(), State{0, 0});
+
+        std::size_t active = keys.size();
+        for (std::size_t i = 0; i < keys.size(); ++i) out[i] = nullptr;
+
+        while (active > 0) {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                if (st[i].node == npos) continue;
+
+                if (st[i].pos == keys[i].size()) {       // key fully walked
+                    if (nodes_[st[i].node].has_value())
+                        out[i] = &value_pool_[nodes_[st[i].node].value_idx];
+                    st[i].node = npos;
+                    --active;
+                    continue;
+                }
+
+                const std::uint32_t next =
+                    find_child(st[i].node, keys[i][st[i].pos]);
+                if (next == npos) {                      // dead end
+                    st[i].node = npos;
+                    --active;
+                    continue;
+                }
+                __builtin_prefetch(&nodes_[next], 0, 3); // hide the next hop
+                st[i].node = next;
+                ++st[i].pos;
+            }
+        }
+    }
+    void find_batch(std::span<const std::basic_string_view<CharT>> keys,
+                    std::span<const T*> out) const noexcept
+    {
+        const_cast<pool_trie*>(this)->find_batch(
+            keys, {const_cast<T**>(out.data()), out.size()});
+    }
+
     // --------------------------------------------------- CONTAINS --------
     [[nodiscard]] bool contains(std::basic_string_view<CharT> key) const noexcept
     { return find(key) != nullptr; }
 
+    // --------------------------------------------------- PREFIX ----------
+    // Longest-prefix match in a single walk of key: returns the value of
+    // the deepest prefix that has one (or nullptr).  *match_len receives
+    // that prefix's length.  Replaces probing every prefix with its own
+    // find() — one root-to-leaf walk instead of up to |key| of them.
+    [[nodiscard]] T* longest_prefix_match(std::basic_string_view<CharT> key,
+                                          std::size_t* match_len = nullptr) noexcept
+    {
+        std::uint32_t cur   = 0;
+        std::size_t   depth = 0;
+        T*            best  = nodes_[0].has_value()          // empty-key entry
+                                ? &value_pool_[nodes_[0].value_idx] : nullptr;
+        std::size_t   best_len = 0;
+
+        for (CharT ch : key) {
+            cur = find_child(cur, ch);
+            if (cur == npos) break;
+            ++depth;
+            if (nodes_[cur].has_value()) {
+                best     = &value_pool_[nodes_[cur].value_idx];
+                best_len = depth;
+            }
+        }
+        if (match_len) *match_len = best_len;
+        return best;
+    }
+    [[nodiscard]] const T* longest_prefix_match(std::basic_string_view<CharT> key,
+                                                std::size_t* match_len = nullptr) const noexcept
+    { return const_cast<pool_trie*>(this)->longest_prefix_match(key, match_len); }
+
+    // Enumerate every (key, value) in the subtree under prefix, in label
+    // order, without materializing key strings: full keys are exposed as
+    // string_views over the caller-provided buffer (≥ 64 chars, the max
+    // key length).  cb is called as cb(key_view, value).
+    template<class F>
+    void visit_prefix(std::basic_string_view<CharT> prefix,
+                      CharT* buffer, std::size_t buffer_cap, F&& cb) const
+    {
+        assert(buffer_cap >= 64 && "buffer must hold a maximum-length key");
+        (void)buffer_cap;
+
+        std::uint32_t cur = 0;
+        for (CharT ch : prefix) {
+            cur = find_child(cur, ch);
+            if (cur == npos) return;                 // nothing under prefix
+        }
+        std::copy(prefix.begin(), prefix.end(), buffer);
+        visit_subtree(cur, buffer, prefix.size(), cb);
+    }
+
+    // --------------------------------------------------- SNAPSHOT --------
+    // Write a version-1 binary snapshot (see namespace snapshot).  Restart
+    // becomes mapped_pool_trie::open() — one mmap, zero deserialization,
+    // pages faulted on first lookup.
+    bool save(const char* path) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "snapshots require trivially copyable values");
+        static_assert(sizeof(Node) == 16,
+            "snapshot layout expects 16-byte nodes");
+
+        std::vector<snapshot::flat_bitmap> flat(bitmap_nodes_.size());
+        std::vector<std::uint32_t>         dense;
+        for (std::size_t i = 0; i < bitmap_nodes_.size(); ++i) {
+            const BitmapNode& b = bitmap_nodes_[i];
+            std::copy(std::begin(b.bits), std::end(b.bits), std::begin(flat[i].bits));
+            flat[i].dense_off = static_cast<std::uint32_t>(dense.size());
+            flat[i].dense_len = static_cast<std::uint32_t>(b.dense.size());
+            dense.insert(dense.end(), b.dense.begin(), b.dense.end());
+        }
+
+        snapshot::header h{};
+        std::copy(std::begin(snapshot::magic), std::end(snapshot::magic), h.magic);
+        h.version      = snapshot::version;
+        h.node_size    = sizeof(Node);
+        h.value_size   = sizeof(T);
+        h.node_count   = nodes_.size();
+        h.bitmap_count = flat.size();
+        h.dense_count  = dense.size();
+        h.value_count  = value_pool_.size();
+
+        // Arena storage may be slab-chained; walk it span by span (a plain
+        // vector is a single span), producing the same contiguous format.
+        auto spans = [](const auto& c, auto&& f) {
+            if constexpr (requires { c.for_each_span(f); }) c.for_each_span(f);
+            else if (!c.empty()) f(c.data(), c.size());
+        };
+
+        std::uint64_t sum = 14695981039346656037ull;
+        spans(nodes_, [&](const Node* p, std::size_t n) {
+            sum = snapshot::fnv1a(p, n * sizeof(Node), sum);
+        });
+        sum = snapshot::fnv1a(flat.data(),  flat.size()  * sizeof(snapshot::flat_bitmap), sum);
+        sum = snapshot::fnv1a(dense.data(), dense.size() * sizeof(std::uint32_t), sum);
+        spans(value_pool_, [&](const T* p, std::size_t n) {
+            sum = snapshot::fnv1a(p, n * sizeof(T), sum);
+        });
+        h.checksum = sum;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        spans(nodes_, [&](const Node* p, std::size_t n) {
+            out.write(reinterpret_cast<const char*>(p), n * sizeof(Node));
+        });
+        out.write(reinterpret_cast<const char*>(flat.data()),
+                  flat.size() * sizeof(snapshot::flat_bitmap));
+        out.write(reinterpret_cast<const char*>(dense.data()),
+                  dense.size() * sizeof(std::uint32_t));
+        spans(value_pool_, [&](const T* p, std::size_t n) {
+            out.write(reinterpret_cast<const char*>(p), n * sizeof(T));
+        });
+        return static_cast<bool>(out);
+    }
+
     // --------------------------------------------------- SIZE / MEM ------
     [[nodiscard]] std::size_t nodes()  const noexcept { return nodes_.size(); }
     [[nodiscard]] std::size_t values() const noexcept { return value_pool_.size(); }
@@ -131,8 +640,16 @@ public:
     [[nodiscard]] std::size_t bytes_values() const noexcept
     { return value_pool_.size() * sizeof(T); }
 
+    [[nodiscard]] std::size_t bytes_bitmaps() const noexcept
+    {
+        std::size_t bytes = bitmap_nodes_.size() * sizeof(BitmapNode);
+        for (const auto& b : bitmap_nodes_)
+            bytes += b.dense.capacity() * sizeof(std::uint32_t);
+        return bytes;
+    }
+
     [[nodiscard]] std::size_t bytes_total()  const noexcept
-    { return bytes_nodes() + bytes_values(); }
+    { return bytes_nodes() + bytes_bitmaps() + bytes_values(); }
 
     // Disable copying (cheap to move)
     pool_trie(const pool_trie&)            = delete;
@@ -142,5 +659,472 @@ public:
     pool_trie& operator=(pool_trie&&) noexcept = default;
 };
 
+// pool_trie on hugepage-backed, copy-free-growth slab arenas; T must be
+// default-constructible (see slab_vector).
+template<class T, class CharT = char>
+using hugepage_pool_trie = pool_trie<T, CharT, slab_vector>;
+
+/* -----------------------------------------------------------
+ *  mapped_pool_trie  –  read-only mmap view of a snapshot
+ * -----------------------------------------------------------
+ *  open() maps a file written by pool_trie::save() and adopts
+ *  the mapping directly: no parsing, no copies, first lookups
+ *  fault pages on demand.  verify() recomputes the checksum to
+ *  detect torn snapshots (reads the whole file — call it from
+ *  a health check, not the serving path).
+ * ----------------------------------------------------------*/
+template<class T, class CharT = char>
+class mapped_pool_trie
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+        "snapshots require trivially copyable values");
+
+    static constexpr std::uint32_t npos       = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t bitmap_tag = 0x8000'0000u;
+
+    // Mirrors pool_trie::Node's 16-byte layout (checked in save()).
+    struct Node
+    {
+        std::uint32_t first_child;
+        std::uint32_t next_sibling;
+        std::uint32_t value_idx;
+        CharT         label;
+    };
+    static_assert(sizeof(Node) == 16, "layout must match pool_trie::Node");
+
+    void*       map_     {nullptr};
+    std::size_t map_len_ {0};
+
+    const snapshot::header*      hdr_    {nullptr};
+    const Node*                  nodes_  {nullptr};
+    const snapshot::flat_bitmap* bitmaps_{nullptr};
+    const std::uint32_t*         dense_  {nullptr};
+    const T*                     values_ {nullptr};
+
+public:
+    mapped_pool_trie() = default;
+    explicit mapped_pool_trie(const char* path) { (void)open(path); }
+    ~mapped_pool_trie() { close(); }
+
+    bool open(const char* path)
+    {
+        close();
+
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<std::size_t>(st.st_size) < sizeof(snapshot::header)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);                                // mapping keeps the file
+        if (p == MAP_FAILED) return false;
+
+        map_     = p;
+        map_len_ = st.st_size;
+        hdr_     = static_cast<const snapshot::header*>(p);
+
+        const std::size_t expected = sizeof(snapshot::header)
+            + hdr_->node_count   * sizeof(Node)
+            + hdr_->bitmap_count * sizeof(snapshot::flat_bitmap)
+            + hdr_->dense_count  * sizeof(std::uint32_t)
+            + hdr_->value_count  * sizeof(T);
+
+        if (!std::equal(std::begin(snapshot::magic), std::end(snapshot::magic),
+                        hdr_->magic)
+            || hdr_->version    != snapshot::version
+            || hdr_->node_size  != sizeof(Node)
+            || hdr_->value_size != sizeof(T)
+            || hdr_->node_count == 0
+            || map_len_ < expected) {
+            close();
+            return false;
+        }
+
+        const char* cur = static_cast<const char*>(p) + sizeof(snapshot::header);
+        nodes_   = reinterpret_cast<const Node*>(cur);
+        cur     += hdr_->node_count * sizeof(Node);
+        bitmaps_ = reinterpret_cast<const snapshot::flat_bitmap*>(cur);
+        cur     += hdr_->bitmap_count * sizeof(snapshot::flat_bitmap);
+        dense_   = reinterpret_cast<const std::uint32_t*>(cur);
+        cur     += hdr_->dense_count * sizeof(std::uint32_t);
+        values_  = reinterpret_cast<const T*>(cur);
+        return true;
+    }
+
+    void close()
+    {
+        if (map_) ::munmap(map_, map_len_);
+        map_ = nullptr; map_len_ = 0;
+        hdr_ = nullptr; nodes_ = nullptr; bitmaps_ = nullptr;
+        dense_ = nullptr; values_ = nullptr;
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return nodes_ != nullptr; }
+
+    // Recompute the payload checksum (faults every page).
+    [[nodiscard]] bool verify() const noexcept
+    {
+        if (!is_open()) return false;
+        const char* payload = static_cast<const char*>(map_) + sizeof(snapshot::header);
+        const std::uint64_t sum = snapshot::fnv1a(
+            payload,
+            hdr_->node_count   * sizeof(Node)
+          + hdr_->bitmap_count * sizeof(snapshot::flat_bitmap)
+          + hdr_->dense_count  * sizeof(std::uint32_t)
+          + hdr_->value_count  * sizeof(T));
+        return sum == hdr_->checksum;
+    }
+
+    // --------------------------------------------------- FIND ------------
+    [[nodiscard]] const T* find(std::basic_string_view<CharT> key) const noexcept
+    {
+        if (!is_open()) return nullptr;
+
+        std::uint32_t cur = 0;
+        for (CharT ch : key) {
+            const std::uint32_t head = nodes_[cur].first_child;
+
+            if (head != npos && (head & bitmap_tag)) {
+                const snapshot::flat_bitmap& b = bitmaps_[head & ~bitmap_tag];
+                const unsigned c = static_cast<unsigned char>(ch);
+                if (!((b.bits[c >> 6] >> (c & 63)) & 1)) return nullptr;
+                std::uint32_t rank = 0;
+                for (unsigned w = 0; w < (c >> 6); ++w)
+                    rank += static_cast<std::uint32_t>(std::popcount(b.bits[w]));
+                const std::uint64_t below =
+                    (c & 63) ? (std::uint64_t(1) << (c & 63)) - 1 : 0;
+                rank += static_cast<std::uint32_t>(std::popcount(b.bits[c >> 6] & below));
+                cur = dense_[b.dense_off + rank];
+            } else {
+                std::uint32_t n = head;
+                while (n != npos && nodes_[n].label != ch)
+                    n = nodes_[n].next_sibling;
+                if (n == npos) return nullptr;
+                cur = n;
+            }
+        }
+        const std::uint32_t vi = nodes_[cur].value_idx;
+        return vi == npos ? nullptr : &values_[vi];
+    }
+
+    [[nodiscard]] bool contains(std::basic_string_view<CharT> key) const noexcept
+    { return find(key) != nullptr; }
+
+    [[nodiscard]] std::size_t nodes()  const noexcept
+    { return hdr_ ? hdr_->node_count : 0; }
+    [[nodiscard]] std::size_t values() const noexcept
+    { return hdr_ ? hdr_->value_count : 0; }
+
+    mapped_pool_trie(const mapped_pool_trie&)            = delete;
+    mapped_pool_trie& operator=(const mapped_pool_trie&) = delete;
+};
+
+/* -----------------------------------------------------------
+ *  sharded_pool_trie  –  parallel bulk construction facade
+ * -----------------------------------------------------------
+ *  Partitions keys by leading byte into 256 independent
+ *  pool_trie shards and builds them on worker threads — each
+ *  shard owns its arenas, so construction scales across cores
+ *  with zero contention (workers claim whole buckets from an
+ *  atomic counter, which also rides out skewed distributions).
+ *  find() dispatches on the first byte into the shard, which
+ *  stores the key's remainder.  merge() folds everything into
+ *  one frozen pool_trie when a single arena is wanted (e.g.
+ *  for save()/mapped_pool_trie snapshots).
+ * ----------------------------------------------------------*/
+template<class T, class CharT = char>
+class sharded_pool_trie
+{
+    static constexpr std::size_t kShards = 256;
+
+    std::array<pool_trie<T, CharT>, kShards> shards_;
+    bool has_empty_ {false};      // the one key with no leading byte
+    T    empty_value_{};
+
+    [[nodiscard]] static std::size_t shard_of(CharT c) noexcept
+    { return static_cast<unsigned char>(c); }
+
+public:
+    sharded_pool_trie() = default;
+
+    // Build from a (key, value) range with num_threads workers.
+    template<class It>
+    sharded_pool_trie(It first, It last,
+                      unsigned num_threads = std::thread::hardware_concurrency())
+    {
+        using pair_type = typename std::iterator_traits<It>::value_type;
+
+        // bucket pointers by leading byte; the pairs themselves stay put
+        std::array<std::vector<const pair_type*>, kShards> buckets;
+        for (It it = first; it != last; ++it) {
+            const std::basic_string_view<CharT> key(it->first);
+            if (key.empty()) {
+                has_empty_   = true;
+                empty_value_ = it->second;
+                continue;
+            }
+            buckets[shard_of(key[0])].push_back(&*it);
+        }
+
+        std::atomic<std::size_t> next{0};
+        auto worker = [&] {
+            for (;;) {
+                const std::size_t b = next.fetch_add(1, std::memory_order_relaxed);
+                if (b >= kShards) return;
+                for (const pair_type* kv : buckets[b]) {
+                    const std::basic_string_view<CharT> key(kv->first);
+                    shards_[b].insert(key.substr(1), kv->second);
+                }
+                shards_[b].freeze();          // read-optimized layout per shard
+            }
+        };
+
+        if (num_threads == 0) num_threads = 1;
+        std::vector<std::jthread> workers;
+        workers.reserve(num_threads);
+        for (unsigned t = 0; t < num_threads && t < kShards; ++t)
+            workers.emplace_back(worker);
+    }
+
+    // --------------------------------------------------- LOOKUP ----------
+    [[nodiscard]] T* find(std::basic_string_view<CharT> key) noexcept
+    {
+        if (key.empty()) return has_empty_ ? &empty_value_ : nullptr;
+        return shards_[shard_of(key[0])].find(key.substr(1));
+    }
+    [[nodiscard]] const T* find(std::basic_string_view<CharT> key) const noexcept
+    { return const_cast<sharded_pool_trie*>(this)->find(key); }
+
+    [[nodiscard]] bool contains(std::basic_string_view<CharT> key) const noexcept
+    { return find(key) != nullptr; }
+
+    // Post-build inserts route to the owning shard (single-threaded).
+    template<class U>
+    T& insert(std::basic_string_view<CharT> key, U&& val)
+    {
+        if (key.empty()) {
+            has_empty_   = true;
+            empty_value_ = std::forward<U>(val);
+            return empty_value_;
+        }
+        return shards_[shard_of(key[0])].insert(key.substr(1),
+                                                std::forward<U>(val));
+    }
+
+    // --------------------------------------------------- MERGE -----------
+    // Fold every shard into one frozen single-arena pool_trie.
+    [[nodiscard]] pool_trie<T, CharT> merge() const
+    {
+        pool_trie<T, CharT> out(nodes() + 1, values());
+        CharT buf[65];
+        for (std::size_t b = 0; b < kShards; ++b) {
+            buf[0] = static_cast<CharT>(b);
+            shards_[b].visit_prefix({}, buf + 1, 64,
+                [&](std::basic_string_view<CharT> suffix, const T& v) {
+                    out.insert(std::basic_string_view<CharT>(buf, suffix.size() + 1), v);
+                });
+        }
+        if (has_empty_) out.insert({}, empty_value_);
+        out.freeze();
+        return out;
+    }
+
+    // --------------------------------------------------- SIZE / MEM ------
+    [[nodiscard]] std::size_t nodes() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& s : shards_) n += s.nodes();
+        return n;
+    }
+    [[nodiscard]] std::size_t values() const noexcept
+    {
+        std::size_t n = has_empty_ ? 1 : 0;
+        for (const auto& s : shards_) n += s.values();
+        return n;
+    }
+    [[nodiscard]] std::size_t bytes_total() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& s : shards_) n += s.bytes_total();
+        return n;
+    }
+
+    sharded_pool_trie(const sharded_pool_trie&)            = delete;
+    sharded_pool_trie& operator=(const sharded_pool_trie&) = delete;
+
+    sharded_pool_trie(sharded_pool_trie&&)            noexcept = default;
+    sharded_pool_trie& operator=(sharded_pool_trie&&) noexcept = default;
+};
+
+/* -----------------------------------------------------------
+ *  concurrent_pool_trie  –  single-writer / many-reader variant
+ * -----------------------------------------------------------
+ *  • find()/contains() are wait-free and write nothing shared:
+ *    no mutex, no refcount, no cacheline ping-pong.
+ *  • One thread may insert() concurrently with any number of
+ *    readers.  Links are published with release stores after the
+ *    node is fully built; readers walk them with acquire loads.
+ *  • Storage is slab-chained and append-only — nodes and values
+ *    never move and are never freed while the trie is alive, so
+ *    no epoch/RCU reclamation machinery is needed.  Overwriting
+ *    an existing key RCU-publishes a fresh value slot (the old
+ *    slot stays until destruction; fine for rare updates).
+ *  • T must be default-constructible (slab allocation).
+ *  • Capacity: kMaxSlabs × kSlabSize = 128 Mi nodes / values.
+ * ----------------------------------------------------------*/
+template<class T, class CharT = char>
+class concurrent_pool_trie
+{
+    static_assert(sizeof(CharT) == 1,
+        "This implementation assumes 1‑byte code units (ASCII/UTF‑8).");
+
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    static constexpr std::size_t kSlabSize = 4096;   // entries per slab
+    static constexpr std::size_t kMaxSlabs = 32768;  // directory entries
+
+    struct Node
+    {
+        std::atomic<std::uint32_t> first_child {npos};
+        std::atomic<std::uint32_t> next_sibling{npos};
+        std::atomic<std::uint32_t> value_idx   {npos};
+        CharT                      label       {0};  // written before publish
+    };
+
+    // Slab directories are fixed-size arrays of atomic pointers, so the
+    // writer can grow storage without ever relocating what readers hold.
+    std::array<std::atomic<Node*>, kMaxSlabs> node_slabs_ {};
+    std::array<std::atomic<T*>,    kMaxSlabs> value_slabs_{};
+
+    std::atomic<std::uint32_t> node_count_ {0};
+    std::atomic<std::uint32_t> value_count_{0};
+
+    [[nodiscard]] Node& node(std::uint32_t i) const noexcept
+    {
+        Node* slab = node_slabs_[i / kSlabSize].load(std::memory_order_acquire);
+        return slab[i % kSlabSize];
+    }
+    [[nodiscard]] T& value(std::uint32_t i) const noexcept
+    {
+        T* slab = value_slabs_[i / kSlabSize].load(std::memory_order_acquire);
+        return slab[i % kSlabSize];
+    }
+
+    // ---- writer-side helpers (single writer by contract) ---------------
+    [[nodiscard]] std::uint32_t make_node(CharT lbl)
+    {
+        const std::uint32_t idx = node_count_.load(std::memory_order_relaxed);
+        assert(idx / kSlabSize < kMaxSlabs && "concurrent_pool_trie capacity exceeded");
+        if (idx % kSlabSize == 0 &&
+            node_slabs_[idx / kSlabSize].load(std::memory_order_relaxed) == nullptr)
+            node_slabs_[idx / kSlabSize].store(new Node[kSlabSize],
+                                               std::memory_order_release);
+        node(idx).label = lbl;                       // unpublished yet
+        node_count_.store(idx + 1, std::memory_order_relaxed);
+        return idx;
+    }
+
+    [[nodiscard]] std::uint32_t make_value()
+    {
+        const std::uint32_t idx = value_count_.load(std::memory_order_relaxed);
+        assert(idx / kSlabSize < kMaxSlabs && "concurrent_pool_trie capacity exceeded");
+        if (idx % kSlabSize == 0 &&
+            value_slabs_[idx / kSlabSize].load(std::memory_order_relaxed) == nullptr)
+            value_slabs_[idx / kSlabSize].store(new T[kSlabSize],
+                                                std::memory_order_release);
+        value_count_.store(idx + 1, std::memory_order_relaxed);
+        return idx;
+    }
+
+    // Insert child in sorted sibling list; new links are release-published
+    // so a concurrent reader sees either the old chain or the new one.
+    [[nodiscard]] std::uint32_t emplace_child(std::uint32_t parent, CharT lbl)
+    {
+        std::atomic<std::uint32_t>* link = &node(parent).first_child;
+        std::uint32_t cur = link->load(std::memory_order_relaxed);
+        while (cur != npos && node(cur).label < lbl) {
+            link = &node(cur).next_sibling;
+            cur  = link->load(std::memory_order_relaxed);
+        }
+        if (cur != npos && node(cur).label == lbl) return cur;
+
+        const std::uint32_t new_idx = make_node(lbl);
+        node(new_idx).next_sibling.store(cur, std::memory_order_relaxed);
+        link->store(new_idx, std::memory_order_release);   // publish
+        return new_idx;
+    }
+
+public:
+    concurrent_pool_trie() { (void)make_node(CharT{0}); } // root is node 0
+
+    ~concurrent_pool_trie()
+    {
+        for (auto& s : node_slabs_)  delete[] s.load(std::memory_order_relaxed);
+        for (auto& s : value_slabs_) delete[] s.load(std::memory_order_relaxed);
+    }
+
+    // --------------------------------------------------- INSERT ----------
+    // Single writer only; safe against any number of concurrent find()s.
+    template<class U>
+    T& insert(std::basic_string_view<CharT> key, U&& val)
+    {
+        assert(key.size() <= 64 && "key length > 64 not allowed.");
+
+        std::uint32_t cur = 0; // root
+        for (CharT ch : key)
+            cur = emplace_child(cur, ch);
+
+        // RCU-style value publication: build the slot, then swing the index.
+        const std::uint32_t vi = make_value();
+        value(vi) = std::forward<U>(val);
+        node(cur).value_idx.store(vi, std::memory_order_release);
+        return value(vi);
+    }
+
+    // --------------------------------------------------- FIND ------------
+    // Wait-free; performs no shared writes.
+    [[nodiscard]] const T* find(std::basic_string_view<CharT> key) const noexcept
+    {
+        std::uint32_t cur = 0;
+        for (CharT ch : key) {
+            std::uint32_t c =
+                node(cur).first_child.load(std::memory_order_acquire);
+            while (c != npos && node(c).label != ch)
+                c = node(c).next_sibling.load(std::memory_order_acquire);
+            if (c == npos) return nullptr;
+            cur = c;
+        }
+        const std::uint32_t vi =
+            node(cur).value_idx.load(std::memory_order_acquire);
+        return vi == npos ? nullptr : &value(vi);
+    }
+
+    [[nodiscard]] bool contains(std::basic_string_view<CharT> key) const noexcept
+    { return find(key) != nullptr; }
+
+    // --------------------------------------------------- SIZE / MEM ------
+    [[nodiscard]] std::size_t nodes()  const noexcept
+    { return node_count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::size_t values() const noexcept
+    { return value_count_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] std::size_t bytes_total() const noexcept
+    {
+        std::size_t bytes = 0;
+        for (auto& s : node_slabs_)
+            if (s.load(std::memory_order_relaxed)) bytes += kSlabSize * sizeof(Node);
+        for (auto& s : value_slabs_)
+            if (s.load(std::memory_order_relaxed)) bytes += kSlabSize * sizeof(T);
+        return bytes;
+    }
+
+    // Neither copyable nor movable: readers hold interior pointers.
+    concurrent_pool_trie(const concurrent_pool_trie&)            = delete;
+    concurrent_pool_trie& operator=(const concurrent_pool_trie&) = delete;
+};
+
 } // namespace fast
 // ────────────────────────────────────────────────────────────────────────
\ No newline at end of file
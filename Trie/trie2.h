@@ -7,6 +7,9 @@
 #include <string_view>
 #include <optional>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <stdexcept>
 #include <utility>
 
@@ -15,27 +18,28 @@ class Trie {
 private:
     static constexpr size_t ALPHABET_SIZE = 128; // ASCII characters
     static constexpr size_t MAX_KEY_LENGTH = 64;
-    
+    static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
     struct TrieNode {
-        // Using array for children - faster than unordered_map for ASCII
-        std::unique_ptr<TrieNode> children[ALPHABET_SIZE];
+        // Index-linked children into the node pool - same contiguous-pool
+        // storage pool_trie uses, so no per-node heap allocation at all
+        uint32_t children[ALPHABET_SIZE];
         std::optional<size_t> value_index; // Index into value pool
-        
-        TrieNode() = default;
-        
-        // Move constructor and assignment
-        TrieNode(TrieNode&&) = default;
-        TrieNode& operator=(TrieNode&&) = default;
-        
-        // Delete copy operations
-        TrieNode(const TrieNode&) = delete;
-        TrieNode& operator=(const TrieNode&) = delete;
+
+        TrieNode() {
+            std::fill(std::begin(children), std::end(children), NO_NODE);
+        }
     };
-    
-    std::unique_ptr<TrieNode> root;
+
+    // Per-instance arenas: nodes and values live in contiguous vectors,
+    // construction is allocation-free after reserve, and teardown is an
+    // O(1) vector drop instead of destructor recursion over unique_ptrs.
+    std::vector<TrieNode> node_pool;
+    std::vector<uint32_t> free_node_indices; // Reuse erased node slots
     std::vector<ValueType> value_pool;
     std::vector<size_t> free_indices; // Reuse deleted value slots
-    
+    double auto_defrag_ratio = 0.0;   // Hole fraction triggering defragment()
+
     // Helper to validate key
     static void validate_key(std::string_view key) {
         if (key.empty() || key.length() > MAX_KEY_LENGTH) {
@@ -47,29 +51,50 @@ private:
             }
         }
     }
-    
+
+    uint32_t allocate_node() {
+        if (!free_node_indices.empty()) {
+            uint32_t index = free_node_indices.back();
+            free_node_indices.pop_back();
+            node_pool[index] = TrieNode(); // Reset reused slot
+            return index;
+        }
+        node_pool.emplace_back();
+        return static_cast<uint32_t>(node_pool.size() - 1);
+    }
+
 public:
-    Trie() : root(std::make_unique<TrieNode>()) {
+    Trie() {
+        node_pool.reserve(1024);
+        node_pool.emplace_back(); // Root is node 0
         value_pool.reserve(1024); // Pre-allocate for performance
     }
-    
+
+    // Reserve arena capacity up front so bulk loads never reallocate
+    void reserve(size_t node_cap, size_t value_cap) {
+        node_pool.reserve(node_cap);
+        value_pool.reserve(value_cap);
+    }
+
     // Insert or update key-value pair
     void insert(std::string_view key, ValueType value) {
         validate_key(key);
-        
-        TrieNode* current = root.get();
-        
+
+        uint32_t current = 0; // root
+
         for (char c : key) {
             size_t index = static_cast<unsigned char>(c);
-            if (!current->children[index]) {
-                current->children[index] = std::make_unique<TrieNode>();
+            uint32_t next = node_pool[current].children[index];
+            if (next == NO_NODE) {
+                next = allocate_node(); // May grow the pool; use indices only
+                node_pool[current].children[index] = next;
             }
-            current = current->children[index].get();
+            current = next;
         }
-        
-        if (current->value_index.has_value()) {
+
+        if (node_pool[current].value_index.has_value()) {
             // Update existing value
-            value_pool[current->value_index.value()] = std::move(value);
+            value_pool[node_pool[current].value_index.value()] = std::move(value);
         } else {
             // Insert new value
             size_t new_index;
@@ -83,139 +108,241 @@ public:
                 new_index = value_pool.size();
                 value_pool.push_back(std::move(value));
             }
-            current->value_index = new_index;
+            node_pool[current].value_index = new_index;
         }
     }
-    
+
     // Search for a key and return pointer to value (nullptr if not found)
     ValueType* find(std::string_view key) {
         validate_key(key);
-        
-        TrieNode* current = root.get();
-        
+
+        uint32_t current = 0; // root
+
         for (char c : key) {
             size_t index = static_cast<unsigned char>(c);
-            if (!current->children[index]) {
+            uint32_t next = node_pool[current].children[index];
+            if (next == NO_NODE) {
                 return nullptr;
             }
-            current = current->children[index].get();
+            current = next;
         }
-        
-        if (current->value_index.has_value()) {
-            return &value_pool[current->value_index.value()];
+
+        if (node_pool[current].value_index.has_value()) {
+            return &value_pool[node_pool[current].value_index.value()];
         }
         return nullptr;
     }
-    
+
     // Const version of find
     const ValueType* find(std::string_view key) const {
         return const_cast<Trie*>(this)->find(key);
     }
-    
+
+    // Batched lookup: traversals of all keys are interleaved one character
+    // per round, prefetching each key's next node so the dependent cache
+    // misses of many lookups overlap. out[i] receives find(keys[i]).
+    // Keys are validated up front (throws like find does).
+    void find_batch(std::span<const std::string_view> keys,
+                    std::span<ValueType*> out) {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument("find_batch: output span too small");
+        }
+        for (std::string_view key : keys) {
+            validate_key(key);
+        }
+
+        struct State {
+            uint32_t node;
+            size_t pos;
+        };
+        std::vector<State> st(keys.size());
+
+        size_t active = keys.size();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            st[i] = {0, 0};
+            out[i] = nullptr;
+        }
+
+        while (active > 0) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (st[i].node == NO_NODE) continue;
+
+                if (st[i].pos == keys[i].size()) { // key fully walked
+                    if (node_pool[st[i].node].value_index.has_value()) {
+                        out[i] = &value_pool[node_pool[st[i].node].value_index.value()];
+                    }
+                    st[i].node = NO_NODE;
+                    --active;
+                    continue;
+                }
+
+                size_t index = static_cast<unsigned char>(keys[i][st[i].pos]);
+                uint32_t next = node_pool[st[i].node].children[index];
+                if (next == NO_NODE) { // dead end
+                    st[i].node = NO_NODE;
+                    --active;
+                    continue;
+                }
+                __builtin_prefetch(&node_pool[next], 0, 3); // hide the next hop
+                st[i].node = next;
+                ++st[i].pos;
+            }
+        }
+    }
+
     // Check if key exists
     bool contains(std::string_view key) const {
         return find(key) != nullptr;
     }
-    
+
     // Remove a key-value pair
     bool erase(std::string_view key) {
         validate_key(key);
-        
-        std::vector<TrieNode*> path;
+
+        std::vector<uint32_t> path;
         path.reserve(key.length() + 1);
-        
-        TrieNode* current = root.get();
+
+        uint32_t current = 0; // root
         path.push_back(current);
-        
+
         // Find the node
         for (char c : key) {
             size_t index = static_cast<unsigned char>(c);
-            if (!current->children[index]) {
+            uint32_t next = node_pool[current].children[index];
+            if (next == NO_NODE) {
                 return false; // Key not found
             }
-            current = current->children[index].get();
+            current = next;
             path.push_back(current);
         }
-        
-        if (!current->value_index.has_value()) {
+
+        if (!node_pool[current].value_index.has_value()) {
             return false; // Key not found
         }
-        
+
         // Mark value slot as free
-        free_indices.push_back(current->value_index.value());
-        current->value_index.reset();
-        
+        free_indices.push_back(node_pool[current].value_index.value());
+        node_pool[current].value_index.reset();
+
         // Clean up empty nodes
         for (size_t i = path.size() - 1; i > 0; --i) {
-            TrieNode* node = path[i];
-            
+            TrieNode& node = node_pool[path[i]];
+
             // Check if node has any children or value
             bool has_children = false;
-            for (const auto& child : node->children) {
-                if (child) {
+            for (uint32_t child : node.children) {
+                if (child != NO_NODE) {
                     has_children = true;
                     break;
                 }
             }
-            
-            if (!has_children && !node->value_index.has_value()) {
-                // Remove this node
+
+            if (!has_children && !node.value_index.has_value()) {
+                // Unlink and recycle this node
                 char c = key[i - 1];
                 size_t index = static_cast<unsigned char>(c);
-                path[i - 1]->children[index].reset();
+                node_pool[path[i - 1]].children[index] = NO_NODE;
+                free_node_indices.push_back(path[i]);
             } else {
                 break; // Stop cleanup, node is still needed
             }
         }
-        
+
+        if (auto_defrag_ratio > 0.0 && !value_pool.empty() &&
+            free_indices.size() > value_pool.size() * auto_defrag_ratio) {
+            defragment();
+        }
+
         return true;
     }
-    
-    // Clear all entries
+
+    // Clear all entries - O(1) vector drops, no destructor recursion
     void clear() {
-        root = std::make_unique<TrieNode>();
+        node_pool.clear();
+        node_pool.emplace_back(); // Fresh root
+        free_node_indices.clear();
         value_pool.clear();
         free_indices.clear();
     }
-    
+
     // Get number of key-value pairs
     size_t size() const {
         return value_pool.size() - free_indices.size();
     }
-    
+
     // Check if empty
     bool empty() const {
         return size() == 0;
     }
-    
+
     // Operator[] for convenient access (creates if doesn't exist)
     ValueType& operator[](std::string_view key) {
         ValueType* ptr = find(key);
         if (ptr) {
             return *ptr;
         }
-        
+
         // Insert default value and return reference
         insert(key, ValueType{});
         return *find(key);
     }
-    
+
+    // Full value-pool defragmentation: live values move down over the
+    // holes, every node's value_index is rewritten through a remap table,
+    // and the pool shrinks to exactly the live size - so value scans touch
+    // dense memory again after churn. One pass over the value pool plus
+    // one pass over the node pool (freed nodes carry no value_index).
+    void defragment() {
+        if (free_indices.empty()) return;
+
+        std::vector<char> is_free(value_pool.size(), 0);
+        for (size_t idx : free_indices) {
+            is_free[idx] = 1;
+        }
+
+        std::vector<size_t> remap(value_pool.size());
+        size_t next = 0;
+        for (size_t i = 0; i < value_pool.size(); ++i) {
+            if (is_free[i]) continue;
+            if (next != i) {
+                value_pool[next] = std::move(value_pool[i]);
+            }
+            remap[i] = next++;
+        }
+        value_pool.resize(next);
+        value_pool.shrink_to_fit();
+        free_indices.clear();
+        free_indices.shrink_to_fit();
+
+        for (TrieNode& node : node_pool) {
+            if (node.value_index.has_value()) {
+                node.value_index = remap[node.value_index.value()];
+            }
+        }
+    }
+
+    // Automatic defragment() once holes exceed the given fraction of the
+    // pool (checked after each erase); 0 disables
+    void set_auto_defrag_ratio(double ratio) {
+        auto_defrag_ratio = ratio;
+    }
+
     // Memory optimization: compact the value pool
     void compact() {
         if (free_indices.empty()) return;
-        
+
         // Sort free indices in descending order
         std::sort(free_indices.rbegin(), free_indices.rend());
-        
+
         // Remove freed values from the end
         while (!free_indices.empty() && free_indices.back() == value_pool.size() - 1) {
             value_pool.pop_back();
             free_indices.pop_back();
         }
-        
+
         // Could implement more sophisticated compaction if needed
     }
-    
+
     // Get memory statistics
     struct MemoryStats {
         size_t node_count;
@@ -223,32 +350,22 @@ public:
         size_t free_slots;
         size_t approximate_bytes;
     };
-    
+
     MemoryStats get_memory_stats() const {
         MemoryStats stats{};
-        count_nodes(root.get(), stats.node_count);
+        stats.node_count = node_pool.size() - free_node_indices.size();
         stats.value_count = value_pool.size();
         stats.free_slots = free_indices.size();
-        
+
         // Approximate memory usage
-        stats.approximate_bytes = 
-            stats.node_count * sizeof(TrieNode) +
-            stats.value_count * sizeof(ValueType) +
+        stats.approximate_bytes =
+            node_pool.capacity() * sizeof(TrieNode) +
+            value_pool.capacity() * sizeof(ValueType) +
+            free_node_indices.capacity() * sizeof(uint32_t) +
             free_indices.capacity() * sizeof(size_t);
-            
+
         return stats;
     }
-    
-private:
-    void count_nodes(const TrieNode* node, size_t& count) const {
-        if (!node) return;
-        count++;
-        for (const auto& child : node->children) {
-            if (child) {
-                count_nodes(child.get(), count);
-            }
-        }
-    }
 };
 
 #endif // TRIE_KV_STORAGE_HPP
\ No newline at end of file
@@ -6,20 +6,30 @@
 #include <cstdint>
 #include <limits>
 #include <iostream>
+#include <immintrin.h>
 
 template <class Value,
           std::size_t MAX_KEY_LEN = 64>         // compile‑time guard
 class CompactRadixTrie {
+    static_assert(MAX_KEY_LEN <= std::numeric_limits<uint16_t>::max(),
+                  "fragment length is stored in 16 bits");
     //───────────────────────────────────────────────────────────────────
     // 1.  Internal storage types
     //───────────────────────────────────────────────────────────────────
+    // Edges are path-compressed: each one is labeled with a multi-byte
+    // fragment living in a shared arena, so a long unique suffix costs a
+    // single edge + node instead of one node per byte.  Fragments split
+    // lazily the first time two keys diverge inside one.
     struct Edge {
-        char      ch;           // byte that labels this edge
+        char      first;        // fragment's first byte (sibling-scan key)
+        uint16_t  frag_len;     // fragment length in bytes (≥ 1)
+        uint32_t  frag_off;     // offset into frags_
         uint32_t  child;        // index in nodes_
         uint32_t  next;         // sibling edge, 0 = end of list
 
-        Edge(char c = 0, uint32_t child_ = 0, uint32_t next_ = 0)
-            : ch(c), child(child_), next(next_) {}
+        Edge(char f = 0, uint16_t len = 0, uint32_t off = 0,
+             uint32_t child_ = 0, uint32_t next_ = 0)
+            : first(f), frag_len(len), frag_off(off), child(child_), next(next_) {}
     };
 
     struct Node {
@@ -27,10 +37,25 @@ class CompactRadixTrie {
         uint32_t valIndex  = std::numeric_limits<uint32_t>::max(); // npos → no value
     };
 
+    // High-fanout nodes drop the linked sibling chain for a structure-of-
+    // arrays layout: every sibling's first byte in one contiguous array
+    // (searched 16 labels per _mm_cmpeq_epi8/movemask, SSE2 baseline) with
+    // edge-pool indices in a parallel array.  A firstEdge with the tag bit
+    // set indexes soa_ instead of edges_.
+    struct SoAEdges {
+        std::vector<char>     labels;   // first byte of each edge's fragment
+        std::vector<uint32_t> edges;    // parallel edge indices
+    };
+
+    static constexpr uint32_t soa_tag       = 0x80000000u;
+    static constexpr uint32_t kSoAThreshold = 8;   // fanout that promotes
+
     // pools – index 0 in edges_ is a dummy sentinel so “0” means “null”
-    std::vector<Node>  nodes_{ { /* root node */ } };
-    std::vector<Edge>  edges_{ { } };
-    std::vector<Value> vals_;
+    std::vector<Node>     nodes_{ { /* root node */ } };
+    std::vector<Edge>     edges_{ { } };
+    std::vector<SoAEdges> soa_;
+    std::vector<Value>    vals_;
+    std::string           frags_;       // shared fragment arena
 
     static constexpr uint32_t npos32 = std::numeric_limits<uint32_t>::max();
 
@@ -41,24 +66,132 @@ class CompactRadixTrie {
         nodes_.emplace_back();
         return static_cast<uint32_t>(nodes_.size() - 1);
     }
-    uint32_t new_edge(char c, uint32_t child, uint32_t next) {
-        edges_.emplace_back(c, child, next);
+    uint32_t new_edge(const char* frag, uint16_t len, uint32_t child, uint32_t next) {
+        const uint32_t off = static_cast<uint32_t>(frags_.size());
+        frags_.append(frag, len);
+        edges_.emplace_back(frag[0], len, off, child, next);
+        return static_cast<uint32_t>(edges_.size() - 1);
+    }
+    // Edge whose fragment reuses arena bytes already present (splits).
+    uint32_t new_edge_at(uint32_t off, uint16_t len, uint32_t child, uint32_t next) {
+        edges_.emplace_back(frags_[off], len, off, child, next);
         return static_cast<uint32_t>(edges_.size() - 1);
     }
 
-    // Find edge carrying character *c* among the siblings that start at edgeIdx.
-    // Returns {edgeIdx, prevIdx}.  If not found, edgeIdx == 0.
+    // Find edge whose fragment starts with *c* among the siblings that start
+    // at edgeIdx.  Returns {edgeIdx, prevIdx}.  If not found, edgeIdx == 0.
     struct EdgeSearch { uint32_t edge; uint32_t prev; };
     EdgeSearch find_edge(uint32_t first, char c) const {
         uint32_t prev = 0, cur = first;
         while (cur) {
-            if (edges_[cur].ch == c) break;
+            if (edges_[cur].first == c) break;
             prev = cur;
             cur  = edges_[cur].next;
         }
         return { cur, prev };
     }
 
+    // One vector compare per 16 sibling labels, scalar tail below that.
+    static int soa_find_pos(const SoAEdges& s, char c) {
+        const char*  p = s.labels.data();
+        const size_t n = s.labels.size();
+        const __m128i needle = _mm_set1_epi8(c);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p + i));
+            const int m = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+            if (m) return static_cast<int>(i) + __builtin_ctz(m);
+        }
+        for (; i < n; ++i)
+            if (p[i] == c) return static_cast<int>(i);
+        return -1;
+    }
+
+    // Child edge carrying first byte c, whatever the representation (0 = none).
+    uint32_t lookup_child(uint32_t nodeIdx, char c) const {
+        const uint32_t head = nodes_[nodeIdx].firstEdge;
+        if (head & soa_tag) {
+            const SoAEdges& s = soa_[head & ~soa_tag];
+            const int pos = soa_find_pos(s, c);
+            return pos < 0 ? 0 : s.edges[pos];
+        }
+        return find_edge(head, c).edge;
+    }
+
+    // Swap the linked chain for SoA arrays once fanout crosses the threshold.
+    void promote_to_soa(uint32_t nodeIdx) {
+        SoAEdges s;
+        for (uint32_t e = nodes_[nodeIdx].firstEdge; e; ) {
+            s.labels.push_back(edges_[e].first);
+            s.edges.push_back(e);
+            const uint32_t next = edges_[e].next;
+            edges_[e].next = 0;                       // no longer chained
+            e = next;
+        }
+        soa_.push_back(std::move(s));
+        nodes_[nodeIdx].firstEdge = soa_tag | static_cast<uint32_t>(soa_.size() - 1);
+    }
+
+    // Hook a fresh edge under nodeIdx (head of chain, or SoA append).
+    void attach_edge(uint32_t nodeIdx, char c, uint32_t newEdge) {
+        const uint32_t head = nodes_[nodeIdx].firstEdge;
+        if (head & soa_tag) {
+            SoAEdges& s = soa_[head & ~soa_tag];
+            s.labels.push_back(c);
+            s.edges.push_back(newEdge);
+            return;
+        }
+        edges_[newEdge].next  = head;
+        nodes_[nodeIdx].firstEdge = newEdge;
+        uint32_t fanout = 0;
+        for (uint32_t e = newEdge; e; e = edges_[e].next) ++fanout;
+        if (fanout > kSoAThreshold) promote_to_soa(nodeIdx);
+    }
+
+    // Detach an edge (erase path; cold, so the SoA scan is plain).
+    void unlink_edge(uint32_t parent, uint32_t prevEdge, uint32_t edgeIdx) {
+        const uint32_t head = nodes_[parent].firstEdge;
+        if (head & soa_tag) {
+            SoAEdges& s = soa_[head & ~soa_tag];
+            for (size_t i = 0; i < s.edges.size(); ++i)
+                if (s.edges[i] == edgeIdx) {          // order is irrelevant
+                    s.labels[i] = s.labels.back();  s.labels.pop_back();
+                    s.edges[i]  = s.edges.back();   s.edges.pop_back();
+                    break;
+                }
+            if (s.edges.empty()) nodes_[parent].firstEdge = 0;
+            return;
+        }
+        if (prevEdge) edges_[prevEdge].next = edges_[edgeIdx].next;
+        else          nodes_[parent].firstEdge = edges_[edgeIdx].next;
+    }
+
+    // Longest shared prefix of the edge's fragment and key[pos..].
+    uint16_t match_len(const Edge& e, const std::string& key, size_t pos) const {
+        const char*  frag = frags_.data() + e.frag_off;
+        const size_t max  = std::min<size_t>(e.frag_len, key.size() - pos);
+        size_t m = 0;
+        while (m < max && frag[m] == key[pos + m]) ++m;
+        return static_cast<uint16_t>(m);
+    }
+
+    // Split edge e after m matched bytes; returns the new intermediate node.
+    uint32_t split_edge(uint32_t edgeIdx, uint16_t m) {
+        const uint32_t mid      = new_node();
+        Edge&          e        = edges_[edgeIdx];
+        const uint32_t oldChild = e.child;
+        const uint32_t tailOff  = e.frag_off + m;
+        const uint16_t tailLen  = static_cast<uint16_t>(e.frag_len - m);
+
+        e.child    = mid;
+        e.frag_len = m;
+        // tail fragment reuses the arena bytes in place
+        const uint32_t tailEdge = new_edge_at(tailOff, tailLen, oldChild, 0);
+        nodes_[mid].firstEdge = tailEdge;
+        return mid;
+    }
+
 public:
     //───────────────────────────────────────────────────────────────────
     // 3.  Public API
@@ -68,21 +201,33 @@ public:
         if (key.size() > MAX_KEY_LEN) return false;       // guard
 
         uint32_t nodeIdx = 0;                             // start at root
-        for (unsigned char uc : key) {
-            char c = static_cast<char>(uc);
-            auto [edgeIdx, prevIdx] = find_edge(nodes_[nodeIdx].firstEdge, c);
-
-            // Edge exists → follow it.
-            if (edgeIdx) { nodeIdx = edges_[edgeIdx].child; continue; }
-
-            // No edge → create new edge + new node.
-            uint32_t newNode = new_node();
-            uint32_t newEdge = new_edge(c, newNode, 0);
-
-            if (prevIdx)  edges_[prevIdx].next  = newEdge;
-            else          nodes_[nodeIdx].firstEdge = newEdge;
-
-            nodeIdx = newNode;
+        size_t   pos     = 0;
+        while (pos < key.size()) {
+            const uint32_t edgeIdx = lookup_child(nodeIdx, key[pos]);
+
+            // No edge → the whole remaining key becomes one fragment.
+            if (!edgeIdx) {
+                const uint32_t newNode = new_node();
+                const uint32_t newEdge =
+                    new_edge(key.data() + pos,
+                             static_cast<uint16_t>(key.size() - pos), newNode, 0);
+                attach_edge(nodeIdx, key[pos], newEdge);
+                nodeIdx = newNode;
+                pos     = key.size();
+                break;
+            }
+
+            const uint16_t m = match_len(edges_[edgeIdx], key, pos);
+            if (m == edges_[edgeIdx].frag_len) {          // fragment fully matched
+                nodeIdx = edges_[edgeIdx].child;
+                pos    += m;
+                continue;
+            }
+
+            // Diverged inside the fragment → split, then continue from the
+            // intermediate node (next round attaches the key's remainder).
+            nodeIdx = split_edge(edgeIdx, m);
+            pos    += m;
         }
 
         Node& n = nodes_[nodeIdx];
@@ -101,11 +246,17 @@ public:
         if (key.size() > MAX_KEY_LEN) return nullptr;
 
         uint32_t nodeIdx = 0;
-        for (unsigned char uc : key) {
-            char c = static_cast<char>(uc);
-            auto [edgeIdx, _] = find_edge(nodes_[nodeIdx].firstEdge, c);
+        size_t   pos     = 0;
+        while (pos < key.size()) {
+            const uint32_t edgeIdx = lookup_child(nodeIdx, key[pos]);
             if (!edgeIdx) return nullptr;
-            nodeIdx = edges_[edgeIdx].child;
+
+            const Edge& e = edges_[edgeIdx];
+            if (key.size() - pos < e.frag_len) return nullptr;
+            if (frags_.compare(e.frag_off, e.frag_len,
+                               key, pos, e.frag_len) != 0) return nullptr;
+            nodeIdx = e.child;
+            pos    += e.frag_len;
         }
         const Node& n = nodes_[nodeIdx];
         return n.valIndex == npos32 ? nullptr : &vals_[n.valIndex];
@@ -115,18 +266,34 @@ public:
     bool erase(const std::string& key) {
         if (key.size() > MAX_KEY_LEN) return false;
 
-        // We keep a stack to backtrack for edge pruning.
+        // We keep a stack to backtrack for edge pruning (one frame per edge,
+        // so path compression keeps it well under MAX_KEY_LEN entries).
         struct Frame { uint32_t node, prevEdge, edge; };
         Frame stack[MAX_KEY_LEN + 1];
         int   depth = 0;
 
         uint32_t nodeIdx = 0;
-        for (unsigned char uc : key) {
-            char c = static_cast<char>(uc);
-            auto se = find_edge(nodes_[nodeIdx].firstEdge, c);
-            if (!se.edge) return false;                   // key absent
-            stack[depth++] = { nodeIdx, se.prev, se.edge };
-            nodeIdx = edges_[se.edge].child;
+        size_t   pos     = 0;
+        while (pos < key.size()) {
+            const uint32_t head = nodes_[nodeIdx].firstEdge;
+            uint32_t edgeIdx, prevIdx = 0;
+            if (head & soa_tag) {
+                edgeIdx = lookup_child(nodeIdx, key[pos]);
+            } else {
+                auto se = find_edge(head, key[pos]);
+                edgeIdx = se.edge;
+                prevIdx = se.prev;
+            }
+            if (!edgeIdx) return false;                   // key absent
+
+            const Edge& e = edges_[edgeIdx];
+            if (key.size() - pos < e.frag_len) return false;
+            if (frags_.compare(e.frag_off, e.frag_len,
+                               key, pos, e.frag_len) != 0) return false;
+
+            stack[depth++] = { nodeIdx, prevIdx, edgeIdx };
+            nodeIdx = e.child;
+            pos    += e.frag_len;
         }
 
         Node& n = nodes_[nodeIdx];
@@ -141,9 +308,7 @@ public:
             if (nodes_[child].firstEdge || nodes_[child].valIndex != npos32)
                 break;                                    // child still needed
 
-            // Unlink edge
-            if (prevEdge) edges_[prevEdge].next = edges_[edge].next;
-            else          nodes_[parent].firstEdge = edges_[edge].next;
+            unlink_edge(parent, prevEdge, edge);
         }
         return true;
     }
@@ -152,19 +317,28 @@ public:
     // 4.  Memory statistics
     //───────────────────────────────────────────────────────────────────
     struct MemUsage {
-        std::size_t node_bytes, edge_bytes, value_bytes;
-        std::size_t total() const { return node_bytes + edge_bytes + value_bytes; }
+        std::size_t node_bytes, edge_bytes, value_bytes, frag_bytes, soa_bytes;
+        std::size_t total() const
+        { return node_bytes + edge_bytes + value_bytes + frag_bytes + soa_bytes; }
     };
 
     MemUsage memory_used() const {
+        std::size_t soa_bytes = soa_.size() * sizeof(SoAEdges);
+        for (const auto& s : soa_)
+            soa_bytes += s.labels.capacity() + s.edges.capacity() * sizeof(uint32_t);
         return { nodes_.size() * sizeof(Node),
                  edges_.size() * sizeof(Edge),
-                 vals_.size()  * sizeof(Value) };
+                 vals_.size()  * sizeof(Value),
+                 frags_.size(),
+                 soa_bytes };
     }
     MemUsage memory_reserved() const {
-        return { nodes_.capacity() * sizeof(Node),
-                 edges_.capacity() * sizeof(Edge),
-                 vals_.capacity()  * sizeof(Value) };
+        MemUsage mu = memory_used();
+        mu.node_bytes  = nodes_.capacity() * sizeof(Node);
+        mu.edge_bytes  = edges_.capacity() * sizeof(Edge);
+        mu.value_bytes = vals_.capacity()  * sizeof(Value);
+        mu.frag_bytes  = frags_.capacity();
+        return mu;
     }
 
     std::size_t key_count()   const { return vals_.size(); }
@@ -191,6 +365,6 @@ int main() {
               << "\nEdges: " << trie.edge_count() << '\n';
 
     auto mu = trie.memory_used();
-    std::cout << "Memory used: " << mu.total()/1024.0 << " KiB\n";
+    std::cout << "Memory used: " << mu.total()/1024.0 << " KiB\n";
 }
 #endif
\ No newline at end of file
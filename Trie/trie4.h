@@ -17,7 +17,17 @@ private:
     static constexpr size_t MAX_KEY_LENGTH = 64;
     
     struct TrieNode;
-    using NodePtr = std::unique_ptr<TrieNode>;
+
+    // Custom deleter so unique_ptr returns nodes to our allocator
+    struct NodeDeleter {
+        void operator()(TrieNode* node) const {
+            if (node) {
+                node_allocator.deallocate(node);
+            }
+        }
+    };
+
+    using NodePtr = std::unique_ptr<TrieNode, NodeDeleter>;
     
     // Compact child storage - only store actually used characters
     struct CompactChildren {
@@ -67,18 +77,29 @@ private:
         
         bool empty() const { return children.empty(); }
         size_t size() const { return children.size(); }
+        void clear() { children.clear(); }
     };
     
+    // HAT-trie-style leaf bucket: key tails that haven't earned trie nodes
+    // yet live as sorted (suffix, value_index) pairs scanned flat, which
+    // bounds pointer chasing to the first few key bytes. A bucket bursts
+    // back into trie nodes when it outgrows the configured threshold.
+    struct Bucket {
+        std::vector<std::pair<std::string, uint32_t>> entries; // sorted by suffix
+    };
+
     struct TrieNode {
         CompactChildren children;
         std::optional<uint32_t> value_index; // Use uint32_t to save memory
-        
+        std::unique_ptr<Bucket> bucket;      // Hybrid leaf storage (may be null)
+
         TrieNode() = default;
     };
     
     NodePtr root;
     std::vector<ValueType> value_pool;
     std::vector<uint32_t> free_indices; // Reuse deleted value slots
+    double auto_defrag_ratio = 0.0;     // Hole fraction triggering defragment()
     
     // Memory pool for nodes to reduce allocation overhead
     struct NodeAllocator {
@@ -98,8 +119,7 @@ private:
             if (!free_nodes.empty()) {
                 TrieNode* node = free_nodes.back();
                 free_nodes.pop_back();
-                new (node) TrieNode(); // Placement new
-                return node;
+                return node; // Already reset by deallocate
             }
             
             if (blocks.empty() || blocks.back()->used >= BLOCK_SIZE) {
@@ -111,7 +131,11 @@ private:
         }
         
         void deallocate(TrieNode* node) {
-            node->~TrieNode(); // Explicit destructor call
+            // Reset in place rather than destroying: the owning Block's
+            // vector destroys every node exactly once at teardown
+            node->children.clear();
+            node->value_index.reset();
+            node->bucket.reset();
             free_nodes.push_back(node);
         }
         
@@ -123,15 +147,6 @@ private:
     
     static NodeAllocator node_allocator;
     
-    // Custom deleter for unique_ptr to use our allocator
-    struct NodeDeleter {
-        void operator()(TrieNode* node) const {
-            if (node) {
-                node_allocator.deallocate(node);
-            }
-        }
-    };
-    
     // Helper to make a node using our allocator
     static NodePtr make_node() {
         return NodePtr(node_allocator.allocate(), NodeDeleter{});
@@ -143,7 +158,81 @@ private:
             throw std::invalid_argument("Key must be 1-64 characters long");
         }
     }
-    
+
+    static constexpr size_t DEFAULT_BURST_THRESHOLD = 16;
+    size_t burst_threshold = DEFAULT_BURST_THRESHOLD;
+
+    // Allocate a value slot, reusing freed ones
+    uint32_t allocate_value(ValueType&& value) {
+        uint32_t new_index;
+        if (!free_indices.empty()) {
+            new_index = free_indices.back();
+            free_indices.pop_back();
+            value_pool[new_index] = std::move(value);
+        } else {
+            new_index = static_cast<uint32_t>(value_pool.size());
+            if (new_index >= UINT32_MAX - 1) {
+                throw std::overflow_error("Value pool size exceeded");
+            }
+            value_pool.push_back(std::move(value));
+        }
+        return new_index;
+    }
+
+    static typename std::vector<std::pair<std::string, uint32_t>>::iterator
+    bucket_lower_bound(Bucket& bucket, std::string_view suffix) {
+        return std::lower_bound(
+            bucket.entries.begin(), bucket.entries.end(), suffix,
+            [](const auto& entry, std::string_view s) { return entry.first < s; });
+    }
+
+    // Store key's unconsumed tail in node's bucket; burst when it overflows
+    void bucket_insert(TrieNode* node, std::string_view suffix, ValueType&& value) {
+        if (!node->bucket) {
+            node->bucket = std::make_unique<Bucket>();
+        }
+        auto it = bucket_lower_bound(*node->bucket, suffix);
+        if (it != node->bucket->entries.end() && it->first == suffix) {
+            value_pool[it->second] = std::move(value); // Update existing
+            return;
+        }
+        uint32_t vi = allocate_value(std::move(value));
+        node->bucket->entries.emplace(it, std::string(suffix), vi);
+        if (node->bucket->entries.size() > burst_threshold) {
+            burst(node);
+        }
+    }
+
+    // Distribute a full bucket one level down into trie nodes (the classic
+    // HAT-trie burst). Sorted order is preserved per child, so child
+    // buckets stay sorted without re-sorting.
+    void burst(TrieNode* node) {
+        auto bucket = std::move(node->bucket);
+
+        for (auto& [suffix, vi] : bucket->entries) {
+            NodePtr& child = node->children.insert_or_get(suffix[0]);
+            if (!child) {
+                child = make_node();
+            }
+            if (suffix.size() == 1) {
+                child->value_index = vi;
+            } else {
+                if (!child->bucket) {
+                    child->bucket = std::make_unique<Bucket>();
+                }
+                child->bucket->entries.emplace_back(suffix.substr(1), vi);
+            }
+        }
+
+        // A very skewed bucket can overflow a single child; keep bursting
+        for (auto& child : node->children.children) {
+            if (child.node->bucket &&
+                child.node->bucket->entries.size() > burst_threshold) {
+                burst(child.node.get());
+            }
+        }
+    }
+
 public:
     Trie() : root(make_node()) {
         value_pool.reserve(1024); // Pre-allocate for performance
@@ -177,57 +266,63 @@ public:
     Trie(const Trie&) = delete;
     Trie& operator=(const Trie&) = delete;
     
-    // Insert or update key-value pair
+    // Insert or update key-value pair. Trie nodes are only descended while
+    // they already exist; the unconsumed tail lands in a leaf bucket and
+    // nodes are created by bursting, not per key byte.
     void insert(std::string_view key, ValueType value) {
         validate_key(key);
-        
+
         TrieNode* current = root.get();
-        
-        for (char c : key) {
-            NodePtr& child = current->children.insert_or_get(c);
-            if (!child) {
-                child = make_node();
+        size_t pos = 0;
+
+        for (; pos < key.size(); ++pos) {
+            NodePtr* child = current->children.find(key[pos]);
+            if (!child || !*child) {
+                break;
             }
-            current = child.get();
+            current = child->get();
         }
-        
+
+        if (pos < key.size()) {
+            bucket_insert(current, key.substr(pos), std::move(value));
+            return;
+        }
+
         if (current->value_index.has_value()) {
             // Update existing value
             value_pool[current->value_index.value()] = std::move(value);
         } else {
-            // Insert new value
-            uint32_t new_index;
-            if (!free_indices.empty()) {
-                // Reuse a freed slot
-                new_index = free_indices.back();
-                free_indices.pop_back();
-                value_pool[new_index] = std::move(value);
-            } else {
-                // Add to end of pool
-                new_index = static_cast<uint32_t>(value_pool.size());
-                if (new_index >= UINT32_MAX - 1) {
-                    throw std::overflow_error("Value pool size exceeded");
-                }
-                value_pool.push_back(std::move(value));
-            }
-            current->value_index = new_index;
+            current->value_index = allocate_value(std::move(value));
         }
     }
-    
+
     // Search for a key and return pointer to value (nullptr if not found)
     ValueType* find(std::string_view key) {
         validate_key(key);
-        
+
         TrieNode* current = root.get();
-        
-        for (char c : key) {
-            NodePtr* child = current->children.find(c);
+        size_t pos = 0;
+
+        for (; pos < key.size(); ++pos) {
+            NodePtr* child = current->children.find(key[pos]);
             if (!child || !*child) {
-                return nullptr;
+                break;
             }
             current = child->get();
         }
-        
+
+        if (pos < key.size()) {
+            // Rest of the key, if present, lives in this node's bucket
+            if (!current->bucket) {
+                return nullptr;
+            }
+            auto it = bucket_lower_bound(*current->bucket, key.substr(pos));
+            if (it == current->bucket->entries.end() || it->first != key.substr(pos)) {
+                return nullptr;
+            }
+            return &value_pool[it->second];
+        }
+
         if (current->value_index.has_value()) {
             return &value_pool[current->value_index.value()];
         }
@@ -255,42 +350,100 @@ public:
         
         std::vector<PathNode> path;
         path.reserve(key.length() + 1);
-        
+
         TrieNode* current = root.get();
         path.push_back({current, '\0'});
-        
-        // Find the node
-        for (char c : key) {
-            NodePtr* child = current->children.find(c);
+        size_t pos = 0;
+
+        // Find the node (or the bucket holding the key's tail)
+        for (; pos < key.size(); ++pos) {
+            NodePtr* child = current->children.find(key[pos]);
             if (!child || !*child) {
-                return false; // Key not found
+                break;
             }
             current = child->get();
-            path.push_back({current, c});
+            path.push_back({current, key[pos]});
         }
-        
-        if (!current->value_index.has_value()) {
-            return false; // Key not found
+
+        if (pos < key.size()) {
+            // Tail must be a bucket entry
+            if (!current->bucket) {
+                return false; // Key not found
+            }
+            auto it = bucket_lower_bound(*current->bucket, key.substr(pos));
+            if (it == current->bucket->entries.end() || it->first != key.substr(pos)) {
+                return false; // Key not found
+            }
+            free_indices.push_back(it->second);
+            current->bucket->entries.erase(it);
+            if (current->bucket->entries.empty()) {
+                current->bucket.reset();
+            }
+        } else {
+            if (!current->value_index.has_value()) {
+                return false; // Key not found
+            }
+            // Mark value slot as free
+            free_indices.push_back(current->value_index.value());
+            current->value_index.reset();
         }
-        
-        // Mark value slot as free
-        free_indices.push_back(current->value_index.value());
-        current->value_index.reset();
-        
+
         // Clean up empty nodes
         for (size_t i = path.size() - 1; i > 0; --i) {
             TrieNode* node = path[i].node;
-            
-            if (node->children.empty() && !node->value_index.has_value()) {
+
+            if (node->children.empty() && !node->value_index.has_value() &&
+                !node->bucket) {
                 // Remove this node
                 path[i - 1].node->children.remove(path[i].ch);
             } else {
                 break; // Stop cleanup, node is still needed
             }
         }
-        
+
+        if (auto_defrag_ratio > 0.0 && !value_pool.empty() &&
+            free_indices.size() > value_pool.size() * auto_defrag_ratio) {
+            defragment();
+        }
+
         return true;
     }
+
+    // Full value-pool defragmentation: live values move down over the
+    // holes, then one trie walk rewrites every node's value_index and
+    // every bucket entry through a remap table, and the pool shrinks to
+    // the live size. (The walk starts at the root - the node allocator's
+    // blocks are shared across instances, so they cannot be scanned flat.)
+    void defragment() {
+        if (free_indices.empty()) return;
+
+        std::vector<char> is_free(value_pool.size(), 0);
+        for (uint32_t idx : free_indices) {
+            is_free[idx] = 1;
+        }
+
+        std::vector<uint32_t> remap(value_pool.size());
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < value_pool.size(); ++i) {
+            if (is_free[i]) continue;
+            if (next != i) {
+                value_pool[next] = std::move(value_pool[i]);
+            }
+            remap[i] = next++;
+        }
+        value_pool.resize(next);
+        value_pool.shrink_to_fit();
+        free_indices.clear();
+        free_indices.shrink_to_fit();
+
+        remap_values(root.get(), remap);
+    }
+
+    // Automatic defragment() once holes exceed the given fraction of the
+    // pool (checked after each erase); 0 disables
+    void set_auto_defrag_ratio(double ratio) {
+        auto_defrag_ratio = ratio;
+    }
     
     // Clear all entries
     void clear() {
@@ -308,6 +461,16 @@ public:
     bool empty() const {
         return size() == 0;
     }
+
+    // Tune when leaf buckets burst into trie nodes (1 = always burst,
+    // i.e. the classic dense behavior; larger = flatter, less chasing)
+    void set_burst_threshold(size_t threshold) {
+        burst_threshold = std::max<size_t>(1, threshold);
+    }
+
+    size_t get_burst_threshold() const {
+        return burst_threshold;
+    }
     
     // Operator[] for convenient access (creates if doesn't exist)
     ValueType& operator[](std::string_view key) {
@@ -343,23 +506,26 @@ public:
         size_t value_count;
         size_t free_slots;
         size_t child_entries;
+        size_t bucket_entries;
         size_t approximate_bytes;
     };
-    
+
     MemoryStats get_memory_stats() const {
         MemoryStats stats{};
-        count_nodes(root.get(), stats.node_count, stats.child_entries);
+        count_nodes(root.get(), stats.node_count, stats.child_entries,
+                    stats.bucket_entries);
         stats.value_count = value_pool.size();
         stats.free_slots = free_indices.size();
         
         // More accurate memory calculation
-        stats.approximate_bytes = 
+        stats.approximate_bytes =
             stats.node_count * sizeof(TrieNode) +
-            stats.child_entries * sizeof(CompactChildren::Child) +
+            stats.child_entries * sizeof(typename CompactChildren::Child) +
+            stats.bucket_entries * sizeof(std::pair<std::string, uint32_t>) +
             value_pool.capacity() * sizeof(ValueType) +
             free_indices.capacity() * sizeof(uint32_t) +
             node_allocator.blocks.size() * NodeAllocator::BLOCK_SIZE * sizeof(TrieNode);
-            
+
         return stats;
     }
     
@@ -369,13 +535,30 @@ public:
     }
     
 private:
-    void count_nodes(const TrieNode* node, size_t& node_count, size_t& child_count) const {
+    void remap_values(TrieNode* node, const std::vector<uint32_t>& remap) {
+        if (!node) return;
+        if (node->value_index.has_value()) {
+            node->value_index = remap[node->value_index.value()];
+        }
+        if (node->bucket) {
+            for (auto& entry : node->bucket->entries) {
+                entry.second = remap[entry.second];
+            }
+        }
+        for (auto& child : node->children.children) {
+            remap_values(child.node.get(), remap);
+        }
+    }
+
+    void count_nodes(const TrieNode* node, size_t& node_count, size_t& child_count,
+                     size_t& bucket_count) const {
         if (!node) return;
         node_count++;
         child_count += node->children.size();
-        
+        if (node->bucket) bucket_count += node->bucket->entries.size();
+
         for (const auto& child : node->children.children) {
-            count_nodes(child.node.get(), node_count, child_count);
+            count_nodes(child.node.get(), node_count, child_count, bucket_count);
         }
     }
 };
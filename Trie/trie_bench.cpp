@@ -0,0 +1,305 @@
+// ──────────────────────────── trie_bench.cpp ───────────────────────────
+// Driver for the unified trie benchmark (see trie_bench.h).
+//
+// Key sets: uniform random, Zipf-skewed, dictionary words and URL paths —
+// the rankings genuinely differ between them, which is why we stopped
+// picking tries by gut feeling.  Phases: insert, find (with sampled p99),
+// erase and a 70/20/10 find/insert/erase mix; memory is reported as
+// bytes per key through each trie's own stats API.
+#include "trie_bench.h"
+
+#include "trie.h"    // fast::pool_trie
+#include "trie3.h"   // CompactRadixTrie
+
+#include "../Accumulate/perf_counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace trie_bench {
+
+// ---- adapters living in this TU -------------------------------------------
+
+namespace {
+
+class pool_trie_adapter final : public trie_adapter
+{
+	fast::pool_trie<std::uint32_t> trie_;
+
+public:
+	const char* name() const override { return "pool_trie (trie.h)"; }
+
+	void insert(const std::string& key, std::uint32_t value) override
+	{ trie_.insert(key, value); }
+
+	const std::uint32_t* find(const std::string& key) override
+	{ return trie_.find(key); }
+
+	bool erase(const std::string&) override { return false; }
+	bool supports_erase() const override { return false; }
+
+	std::size_t bytes_used() const override { return trie_.bytes_total(); }
+};
+
+class radix_trie_adapter final : public trie_adapter
+{
+	CompactRadixTrie<std::uint32_t> trie_;
+
+public:
+	const char* name() const override { return "radix trie (trie3.h)"; }
+
+	void insert(const std::string& key, std::uint32_t value) override
+	{ trie_.insert(key, value); }
+
+	const std::uint32_t* find(const std::string& key) override
+	{ return trie_.find(key); }
+
+	bool erase(const std::string& key) override { return trie_.erase(key); }
+	bool supports_erase() const override { return true; }
+
+	std::size_t bytes_used() const override { return trie_.memory_used().total(); }
+};
+
+} // namespace
+
+std::unique_ptr<trie_adapter> make_pool_trie_adapter()
+{ return std::make_unique<pool_trie_adapter>(); }
+
+std::unique_ptr<trie_adapter> make_radix_trie_adapter()
+{ return std::make_unique<radix_trie_adapter>(); }
+
+// ---- key-set generators ----------------------------------------------------
+
+namespace {
+
+std::string random_word(std::mt19937& rng, int min_len, int max_len)
+{
+	const int len = min_len + static_cast<int>(rng() % (max_len - min_len + 1));
+	std::string w(len, 'a');
+	for (char& c : w) c = static_cast<char>('a' + rng() % 26);
+	return w;
+}
+
+std::vector<std::string> keys_uniform(std::size_t n, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<std::string> keys(n);
+	for (auto& k : keys) k = random_word(rng, 4, 32);
+	return keys;
+}
+
+// Zipf-like skew: most accesses (and duplicates) land on a small head.
+std::vector<std::string> keys_zipfian(std::size_t n, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> uni(0.0, 1.0);
+	const std::size_t universe = std::max<std::size_t>(n / 10, 16);
+	std::vector<std::string> dict(universe);
+	for (auto& k : dict) k = random_word(rng, 4, 32);
+	std::vector<std::string> keys(n);
+	for (auto& k : keys) {
+		const auto rank = static_cast<std::size_t>(std::pow(uni(rng), 4.0)
+		                                           * (universe - 1));
+		k = dict[rank];
+	}
+	return keys;
+}
+
+// Real dictionary if available, synthetic syllable words otherwise.
+std::vector<std::string> keys_dictionary(std::size_t n, unsigned seed)
+{
+	std::vector<std::string> keys;
+	std::ifstream in("/usr/share/dict/words");
+	std::string line;
+	while (keys.size() < n && std::getline(in, line)) {
+		if (line.empty() || line.size() > 64) continue;
+		bool ascii = true;
+		for (char c : line) ascii &= static_cast<unsigned char>(c) < 128;
+		if (ascii) keys.push_back(line);
+	}
+	std::mt19937 rng(seed);
+	static const char* syllables[] = {"an", "ber", "cor", "del", "eph",
+	                                  "for", "gam", "hul", "ing", "jo"};
+	while (keys.size() < n) {
+		std::string w;
+		const int parts = 2 + static_cast<int>(rng() % 4);
+		for (int i = 0; i < parts; ++i) w += syllables[rng() % 10];
+		keys.push_back(w);
+	}
+	return keys;
+}
+
+std::vector<std::string> keys_url_paths(std::size_t n, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	static const char* roots[]    = {"/api/v1", "/api/v2", "/static",
+	                                 "/user", "/admin", "/img", "/js"};
+	static const char* entities[] = {"orders", "items", "carts", "users",
+	                                 "events", "flags", "docs"};
+	std::vector<std::string> keys(n);
+	for (auto& k : keys) {
+		k  = roots[rng() % 7];
+		k += '/';
+		k += entities[rng() % 7];
+		k += '/';
+		k += random_word(rng, 4, 12);
+		if (k.size() > 64) k.resize(64);
+	}
+	return keys;
+}
+
+// ---- measurement ------------------------------------------------------------
+
+using clk = std::chrono::high_resolution_clock;
+
+double mops(std::size_t ops, clk::time_point t1, clk::time_point t2)
+{
+	const double ns =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+	return ns > 0 ? ops * 1e3 / ns : 0.0;
+}
+
+struct phase_result
+{
+	double mops_insert = 0, mops_find = 0, mops_erase = 0, mops_mixed = 0;
+	double p99_find_ns = 0;
+	double bytes_per_key = 0;
+};
+
+phase_result run_phases(trie_adapter& trie, const std::vector<std::string>& keys,
+                        unsigned seed)
+{
+	phase_result r;
+	std::mt19937 rng(seed);
+
+	// insert
+	auto t1 = clk::now();
+	for (std::size_t i = 0; i < keys.size(); ++i)
+		trie.insert(keys[i], static_cast<std::uint32_t>(i));
+	auto t2 = clk::now();
+	r.mops_insert   = mops(keys.size(), t1, t2);
+	r.bytes_per_key = double(trie.bytes_used()) / keys.size();
+
+	// find, sampling every 8th op for the p99; TRIE_PERF=1 wraps the phase
+	// in a perf_event readout (IPC, miss rates) via perf_counters.h
+	static const bool want_perf = [] {
+		const char* s = std::getenv("TRIE_PERF");
+		return s && s[0] == '1';
+	}();
+	perf::counter_group counters;
+	if (want_perf) counters.start();
+
+	std::vector<double> sampled;
+	sampled.reserve(keys.size() / 8 + 1);
+	std::size_t sink = 0;
+	t1 = clk::now();
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		if (i % 8 == 0) {
+			const auto s1 = clk::now();
+			sink += trie.find(keys[i]) != nullptr;
+			const auto s2 = clk::now();
+			sampled.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(s2 - s1).count());
+		} else {
+			sink += trie.find(keys[i]) != nullptr;
+		}
+	}
+	t2 = clk::now();
+	r.mops_find = mops(keys.size(), t1, t2);
+	if (want_perf) {
+		counters.stop();
+		perf::print_sample(counters.read(), 0 /* no byte volume for finds */);
+	}
+	std::sort(sampled.begin(), sampled.end());
+	r.p99_find_ns = sampled.empty() ? 0 : sampled[sampled.size() * 99 / 100];
+
+	// erase half, then a 70/20/10 find/insert/erase mix
+	if (trie.supports_erase()) {
+		t1 = clk::now();
+		for (std::size_t i = 0; i < keys.size(); i += 2)
+			sink += trie.erase(keys[i]);
+		t2 = clk::now();
+		r.mops_erase = mops((keys.size() + 1) / 2, t1, t2);
+
+		t1 = clk::now();
+		for (std::size_t i = 0; i < keys.size(); ++i) {
+			const auto& k = keys[rng() % keys.size()];
+			const unsigned op = rng() % 10;
+			if      (op < 7) sink += trie.find(k) != nullptr;
+			else if (op < 9) trie.insert(k, static_cast<std::uint32_t>(i));
+			else             sink += trie.erase(k);
+		}
+		t2 = clk::now();
+		r.mops_mixed = mops(keys.size(), t1, t2);
+	}
+
+	volatile std::size_t keep = sink;
+	(void)keep;
+	return r;
+}
+
+void run_key_set(const char* set_name, const std::vector<std::string>& keys)
+{
+	std::cout << "\n key set: " << set_name << "  (" << keys.size() << " keys)\n";
+	std::cout << "  trie                    ins Mops   find Mops   p99 ns"
+	             "   erase Mops   mixed Mops   bytes/key\n";
+
+	std::unique_ptr<trie_adapter> tries[] = {
+		make_pool_trie_adapter(),
+		make_trie2_adapter(),
+		make_radix_trie_adapter(),
+		make_trie4_adapter(),
+	};
+
+	for (auto& t : tries) {
+		const phase_result r = run_phases(*t, keys, 1234);
+		std::cout << "  " << t->name();
+		for (std::size_t pad = std::string(t->name()).size(); pad < 24; ++pad)
+			std::cout << ' ';
+		std::cout << r.mops_insert << "   " << r.mops_find << "   "
+		          << r.p99_find_ns << "   ";
+		if (t->supports_erase())
+			std::cout << r.mops_erase << "   " << r.mops_mixed;
+		else
+			std::cout << "-   -";
+		std::cout << "   " << r.bytes_per_key << std::endl;
+	}
+}
+
+} // namespace
+} // namespace trie_bench
+
+int main(int argc, char* argv[])
+{
+	using namespace trie_bench;
+
+	std::size_t n = 200'000;
+	std::string only;
+	if (argc > 1) only = argv[1];
+	if (argc > 2) n = std::strtoull(argv[2], nullptr, 10);
+
+	const struct { const char* name;
+	               std::vector<std::string> (*gen)(std::size_t, unsigned); } sets[] = {
+		{"uniform",    keys_uniform},
+		{"zipfian",    keys_zipfian},
+		{"dictionary", keys_dictionary},
+		{"url_paths",  keys_url_paths},
+	};
+
+	bool matched = false;
+	for (const auto& s : sets) {
+		if (!only.empty() && only != s.name) continue;
+		matched = true;
+		run_key_set(s.name, s.gen(n, 42));
+	}
+	if (!matched) {
+		std::cout << "usage: " << argv[0]
+		          << " [uniform|zipfian|dictionary|url_paths] [num_keys]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+// ────────────────────────────────────────────────────────────────────────
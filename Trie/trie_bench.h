@@ -0,0 +1,43 @@
+// ──────────────────────────── trie_bench.h ─────────────────────────────
+// Unified benchmark suite for the four trie implementations.  C++20.
+//
+// The tries expose similar but incompatible APIs (and trie2.h / trie4.h
+// even share an include guard and a class name, so they can never appear
+// in the same translation unit).  Every contender is therefore driven
+// through the small virtual interface below; the dispatch costs a few ns
+// per op but is identical for all of them, so relative numbers hold.
+//
+// Build (each adapter TU isolates one header):
+//   g++ -O2 -std=c++20 trie_bench.cpp trie_bench_trie2.cpp
+//       trie_bench_trie4.cpp -o trie_bench   (one command line)
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trie_bench {
+
+class trie_adapter
+{
+public:
+	virtual ~trie_adapter() = default;
+
+	[[nodiscard]] virtual const char* name() const = 0;
+
+	virtual void                 insert(const std::string& key, std::uint32_t value) = 0;
+	virtual const std::uint32_t* find(const std::string& key)                        = 0;
+	virtual bool                 erase(const std::string& key)                       = 0;
+
+	[[nodiscard]] virtual bool        supports_erase() const = 0;
+	[[nodiscard]] virtual std::size_t bytes_used()     const = 0;
+};
+
+// Factories — trie2/trie4 live in their own translation units.
+std::unique_ptr<trie_adapter> make_pool_trie_adapter();   // Trie/trie.h
+std::unique_ptr<trie_adapter> make_trie2_adapter();       // Trie/trie2.h
+std::unique_ptr<trie_adapter> make_radix_trie_adapter();  // Trie/trie3.h
+std::unique_ptr<trie_adapter> make_trie4_adapter();       // Trie/trie4.h
+
+} // namespace trie_bench
+// ────────────────────────────────────────────────────────────────────────
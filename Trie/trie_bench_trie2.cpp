@@ -0,0 +1,42 @@
+// Adapter TU for Trie/trie2.h.  trie2.h and trie4.h share an include guard
+// and a class name, so each gets its own translation unit and the class is
+// renamed with the preprocessor to keep the linker honest (two different
+// template definitions under one mangled name would be an ODR violation).
+#define Trie TrieArrayPool
+#include "trie2.h"
+#undef Trie
+
+#include "trie_bench.h"
+
+namespace trie_bench {
+
+namespace {
+
+class trie2_adapter final : public trie_adapter
+{
+	TrieArrayPool<std::uint32_t> trie_;
+
+public:
+	const char* name() const override { return "trie2 (array-pool)"; }
+
+	void insert(const std::string& key, std::uint32_t value) override
+	{ trie_.insert(key, value); }
+
+	const std::uint32_t* find(const std::string& key) override
+	{ return trie_.find(key); }
+
+	bool erase(const std::string& key) override
+	{ return trie_.erase(key); }
+
+	bool supports_erase() const override { return true; }
+
+	std::size_t bytes_used() const override
+	{ return trie_.get_memory_stats().approximate_bytes; }
+};
+
+} // namespace
+
+std::unique_ptr<trie_adapter> make_trie2_adapter()
+{ return std::make_unique<trie2_adapter>(); }
+
+} // namespace trie_bench
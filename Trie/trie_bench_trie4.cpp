@@ -0,0 +1,40 @@
+// Adapter TU for Trie/trie4.h.  See trie_bench_trie2.cpp for why the class
+// is renamed and isolated in its own translation unit.
+#define Trie TrieHybridAlloc
+#include "trie4.h"
+#undef Trie
+
+#include "trie_bench.h"
+
+namespace trie_bench {
+
+namespace {
+
+class trie4_adapter final : public trie_adapter
+{
+	TrieHybridAlloc<std::uint32_t> trie_;
+
+public:
+	const char* name() const override { return "trie4 (compact+alloc)"; }
+
+	void insert(const std::string& key, std::uint32_t value) override
+	{ trie_.insert(key, value); }
+
+	const std::uint32_t* find(const std::string& key) override
+	{ return trie_.find(key); }
+
+	bool erase(const std::string& key) override
+	{ return trie_.erase(key); }
+
+	bool supports_erase() const override { return true; }
+
+	std::size_t bytes_used() const override
+	{ return trie_.get_memory_stats().approximate_bytes; }
+};
+
+} // namespace
+
+std::unique_ptr<trie_adapter> make_trie4_adapter()
+{ return std::make_unique<trie4_adapter>(); }
+
+} // namespace trie_bench
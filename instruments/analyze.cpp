@@ -0,0 +1,649 @@
+// fprof_analyze.cpp
+// Native analyzer for the per-thread binary logs written by prof_log_fast
+// (instruments/profiling.cpp).  Replaces the addr2line-spawning Python
+// scripts for the common case: mmaps every <pid>.<tid>.bin, parses the
+// records zero-copy, reconstructs per-thread call stacks, merges thread
+// aggregates in parallel and emits the same CSV columns prof2.py
+// produces.  Decodes both FPROFv1 (fixed 24-byte records) and FPROFv2
+// (compact varint/tsc encoding; timestamps converted via the calibration
+// ratio in the header).
+//
+// Symbolization: dladdr only sees the *analyzing* process, so function
+// names are resolved by reading the recorded executable's ELF symbol
+// table directly (the <pid>.maps / <pid>.exe files fprof_init dumps next
+// to the logs give the load bias), demangled via __cxa_demangle with a
+// cache.  Addresses outside the main executable fall back to hex plus the
+// module path from the maps file.
+//
+// Besides the CSV aggregates, the enter/exit streams can be exported as
+// latency-debugging artifacts: --trace emits Chrome trace_event JSON
+// (complete "X" events, load in chrome://tracing or Perfetto) and
+// --folded emits collapsed stacks for flamegraph.pl, both reconstructed
+// from the per-thread call stacks.  --window A-B (milliseconds relative
+// to the earliest event) clips either export to one latency spike
+// without processing cost for the rest of the log.
+//
+// Build: g++ -O2 -std=c++20 analyze.cpp -o fprof_analyze
+// Usage: fprof_analyze <dir> [--out-prefix P] [--per-thread]
+//                      [--trace out.json] [--folded out.folded]
+//                      [--window A-B]
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dirent.h>
+
+#include "fprof_lz.h"
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// ---- log format (must match profiling.cpp) --------------------------------
+
+struct LogHeader {
+    char     magic[8];   // "FPROFv1"
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t start_ns;
+    uint32_t rec_size;
+    uint32_t flags;
+};
+
+struct Record {
+    uint64_t  ts_ns;
+    uintptr_t fn;
+    uint8_t   type;      // 0=enter, 1=exit
+    uint8_t   pad[7];
+} __attribute__((packed));
+static_assert(sizeof(Record) == 24, "Record size must be 24 bytes");
+
+// FPROFv2: compact encoding (see profiling.cpp) — varint function-table
+// indices and varint rdtsc deltas, converted to ns via the header ratio.
+struct LogHeaderV2 {
+    LogHeader base;
+    uint64_t  tsc_per_sec;
+    uint64_t  start_tsc;
+};
+
+uint64_t read_varint(const uint8_t*& p, const uint8_t* end, bool& ok) {
+    uint64_t v = 0;
+    int shift = 0;
+    while (p < end && shift < 64) {
+        const uint8_t b = *p++;
+        v |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+        shift += 7;
+    }
+    ok = false;
+    return 0;
+}
+
+// Stream every event of a v1 or v2 log through f(fn, ts_ns, type); f
+// returns false to stop early.  Returns false for unknown headers.
+template<class F>
+bool walk_records(const uint8_t* data, size_t size, uint32_t& pid,
+                  uint32_t& tid, F&& f) {
+    if (size < sizeof(LogHeader)) return false;
+    const auto* h = reinterpret_cast<const LogHeader*>(data);
+    pid = h->pid;
+    tid = h->tid;
+
+    if (memcmp(h->magic, "FPROFv1", 8) == 0 && h->rec_size == sizeof(Record)) {
+        const auto* rec = reinterpret_cast<const Record*>(data + sizeof(LogHeader));
+        const size_t count = (size - sizeof(LogHeader)) / sizeof(Record);
+        for (size_t i = 0; i < count; ++i)
+            if (!f(rec[i].fn, rec[i].ts_ns, int(rec[i].type))) return true;
+        return true;
+    }
+
+    if (memcmp(h->magic, "FPROFv2", 8) == 0 && size >= sizeof(LogHeaderV2)) {
+        const auto* h2 = reinterpret_cast<const LogHeaderV2*>(data);
+        if (h2->tsc_per_sec == 0) return false;
+        const double ns_per_tick = 1e9 / double(h2->tsc_per_sec);
+
+        const uint8_t* p   = data + sizeof(LogHeaderV2);
+        const uint8_t* end = data + size;
+        std::vector<uintptr_t> table;
+        uint64_t tsc = h2->start_tsc;
+
+        while (p < end) {
+            bool ok = true;
+            const uint64_t a = read_varint(p, end, ok);
+            if (!ok) break;
+            if (a == 0) {                          // function definition
+                if (size_t(end - p) < sizeof(uintptr_t)) break;
+                uintptr_t fn;
+                memcpy(&fn, p, sizeof fn);
+                p += sizeof fn;
+                table.push_back(fn);
+                continue;
+            }
+            const uint64_t delta = read_varint(p, end, ok);
+            if (!ok) break;
+            tsc += delta;
+            const auto idx = size_t((a >> 1) - 1);
+            if (idx >= table.size()) break;        // torn tail
+            const uint64_t ts_ns = h->start_ns
+                + uint64_t(double(tsc - h2->start_tsc) * ns_per_tick);
+            if (!f(table[idx], ts_ns, int(a & 1))) return true;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Earliest event timestamp of a log (0 if none).
+uint64_t first_timestamp(const uint8_t* data, size_t size) {
+    uint64_t first = 0;
+    uint32_t pid, tid;
+    (void)walk_records(data, size, pid, tid,
+                       [&](uintptr_t, uint64_t ts, int) {
+                           first = ts;
+                           return false;          // stop after one event
+                       });
+    return first;
+}
+
+struct Agg {
+    uint64_t calls = 0;
+    uint64_t incl_ns = 0;
+    uint64_t excl_ns = 0;
+    uint64_t max_incl_ns = 0;
+};
+
+// ---- mmap helper ----------------------------------------------------------
+
+struct Mapping {
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const uint8_t*>(p);
+        size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+    ~Mapping() { if (data) munmap(const_cast<uint8_t*>(data), size); }
+};
+
+// A log materialized for walking: the raw mapping, or — when header flags
+// bit2 marks an LZ-framed payload (FPROF_COMPRESS=1) — the header plus
+// decompressed frames reassembled contiguously.  Torn or corrupt tails
+// truncate cleanly instead of failing the whole file.
+struct LoadedLog {
+    Mapping              map;
+    std::vector<uint8_t> storage;
+    const uint8_t*       data = nullptr;
+    size_t               size = 0;
+
+    bool open(const std::string& path) {
+        if (!map.open(path) || map.size < sizeof(LogHeader)) return false;
+        const auto* h = reinterpret_cast<const LogHeader*>(map.data);
+        if (!(h->flags & 4)) { data = map.data; size = map.size; return true; }
+
+        const size_t hdr = memcmp(h->magic, "FPROFv2", 8) == 0
+                             ? sizeof(LogHeaderV2) : sizeof(LogHeader);
+        if (map.size < hdr) return false;
+        storage.assign(map.data, map.data + hdr);
+
+        const uint8_t* p   = map.data + hdr;
+        const uint8_t* end = map.data + map.size;
+        while (p + 8 <= end) {
+            uint32_t comp, raw;
+            memcpy(&comp, p, 4);
+            memcpy(&raw,  p + 4, 4);
+            p += 8;
+            if (raw == 0) break;
+            const size_t body = comp ? comp : raw;
+            if (body > size_t(end - p)) break;          // torn tail
+            const size_t at = storage.size();
+            storage.resize(at + raw);
+            if (comp) {
+                if (!fprof_lz::decompress(p, comp, storage.data() + at, raw)) {
+                    storage.resize(at);                 // corrupt frame
+                    break;
+                }
+            } else {
+                memcpy(storage.data() + at, p, raw);
+            }
+            p += body;
+        }
+        data = storage.data();
+        size = storage.size();
+        return true;
+    }
+};
+
+// ---- symbolization --------------------------------------------------------
+
+struct MapsEntry {
+    uintptr_t   start, end, base_vma;   // base_vma = start - file offset
+    std::string path;
+};
+
+struct FuncSym {
+    uintptr_t   vma;
+    uint64_t    size;
+    const char* name;                   // points into mapped strtab
+};
+
+class Symbolizer {
+    std::vector<MapsEntry> maps_;
+    Mapping                exe_;
+    std::string            exe_path_;
+    std::vector<FuncSym>   syms_;       // sorted by vma
+    std::unordered_map<uintptr_t, std::pair<std::string, std::string>> cache_;
+    std::mutex             mu_;
+
+    // Parse executable mappings out of a /proc/<pid>/maps snapshot.
+    void parse_maps(const std::string& path) {
+        FILE* f = fopen(path.c_str(), "r");
+        if (!f) return;
+        char line[1024];
+        while (fgets(line, sizeof line, f)) {
+            uintptr_t start, end, off;
+            char perms[8] = {0};
+            char mod[768] = {0};
+            int n = sscanf(line, "%" SCNxPTR "-%" SCNxPTR " %7s %" SCNxPTR
+                                 " %*s %*s %767s",
+                           &start, &end, perms, &off, mod);
+            if (n < 4 || !strchr(perms, 'x')) continue;
+            maps_.push_back({start, end, start - off, n >= 5 ? mod : ""});
+        }
+        fclose(f);
+        std::sort(maps_.begin(), maps_.end(),
+                  [](const MapsEntry& a, const MapsEntry& b) { return a.start < b.start; });
+    }
+
+    // Pull FUNC symbols out of the exe's .symtab (or .dynsym if stripped).
+    void load_exe_symbols(const std::string& dir, uint32_t pid) {
+        {   // path the profiler recorded for us
+            Mapping p;
+            if (p.open(dir + "/" + std::to_string(pid) + ".exe"))
+                exe_path_.assign(reinterpret_cast<const char*>(p.data), p.size);
+        }
+        if (exe_path_.empty() || !exe_.open(exe_path_)) return;
+        if (exe_.size < sizeof(Elf64_Ehdr)) return;
+
+        const auto* eh = reinterpret_cast<const Elf64_Ehdr*>(exe_.data);
+        if (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+            eh->e_ident[EI_CLASS] != ELFCLASS64) return;
+
+        const auto* sh = reinterpret_cast<const Elf64_Shdr*>(exe_.data + eh->e_shoff);
+        const Elf64_Shdr* symtab = nullptr;
+        for (int pass = 0; pass < 2 && !symtab; ++pass) {
+            const Elf64_Word want = pass == 0 ? SHT_SYMTAB : SHT_DYNSYM;
+            for (int i = 0; i < eh->e_shnum; ++i)
+                if (sh[i].sh_type == want) { symtab = &sh[i]; break; }
+        }
+        if (!symtab) return;
+
+        const auto* syms = reinterpret_cast<const Elf64_Sym*>(exe_.data + symtab->sh_offset);
+        const size_t count = symtab->sh_size / sizeof(Elf64_Sym);
+        const char*  strtab = reinterpret_cast<const char*>(
+            exe_.data + sh[symtab->sh_link].sh_offset);
+
+        syms_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (ELF64_ST_TYPE(syms[i].st_info) != STT_FUNC) continue;
+            if (syms[i].st_value == 0 || syms[i].st_name == 0) continue;
+            syms_.push_back({syms[i].st_value, syms[i].st_size,
+                             strtab + syms[i].st_name});
+        }
+        std::sort(syms_.begin(), syms_.end(),
+                  [](const FuncSym& a, const FuncSym& b) { return a.vma < b.vma; });
+    }
+
+    const MapsEntry* find_mapping(uintptr_t addr) const {
+        auto it = std::upper_bound(maps_.begin(), maps_.end(), addr,
+            [](uintptr_t a, const MapsEntry& m) { return a < m.start; });
+        if (it == maps_.begin()) return nullptr;
+        --it;
+        return addr < it->end ? &*it : nullptr;
+    }
+
+public:
+    Symbolizer(const std::string& dir, uint32_t pid) {
+        parse_maps(dir + "/" + std::to_string(pid) + ".maps");
+        load_exe_symbols(dir, pid);
+    }
+
+    // (module, function) for a recorded address; cached.
+    std::pair<std::string, std::string> resolve(uintptr_t addr) {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto hit = cache_.find(addr);
+        if (hit != cache_.end()) return hit->second;
+
+        std::pair<std::string, std::string> out;
+        const MapsEntry* m = find_mapping(addr);
+        if (m) out.first = m->path;
+
+        if (m && m->path == exe_path_ && !syms_.empty()) {
+            const uintptr_t vma = addr - m->base_vma;
+            auto it = std::upper_bound(syms_.begin(), syms_.end(), vma,
+                [](uintptr_t v, const FuncSym& s) { return v < s.vma; });
+            if (it != syms_.begin()) {
+                --it;
+                if (it->size == 0 || vma < it->vma + it->size) {
+                    int status = 0;
+                    char* dem = abi::__cxa_demangle(it->name, nullptr, nullptr, &status);
+                    out.second = (status == 0 && dem) ? dem : it->name;
+                    free(dem);
+                }
+            }
+        }
+        if (out.second.empty()) {
+            char buf[32];
+            snprintf(buf, sizeof buf, "0x%" PRIxPTR, addr);
+            out.second = buf;
+        }
+        cache_.emplace(addr, out);
+        return out;
+    }
+};
+
+// ---- per-log aggregation (zero-copy over the mapped records) --------------
+
+struct LogFile {
+    std::string path;
+    uint32_t    pid = 0, tid = 0;
+    std::unordered_map<uintptr_t, Agg> agg;
+};
+
+bool aggregate_log(LogFile& lf) {
+    LoadedLog log;
+    if (!log.open(lf.path)) return false;
+
+    struct Frame { uintptr_t fn; uint64_t start_ns, child_ns; };
+    std::vector<Frame> stack;
+    stack.reserve(256);
+
+    return walk_records(log.data, log.size, lf.pid, lf.tid,
+        [&](uintptr_t fn, uint64_t ts_ns, int type) {
+            if (type == 0) {
+                stack.push_back({fn, ts_ns, 0});
+                return true;
+            }
+            // exit: drain until the matching frame (mirrors the runtime's
+            // exception-unwind reconciliation)
+            while (!stack.empty()) {
+                Frame fr = stack.back();
+                stack.pop_back();
+
+                const uint64_t incl = ts_ns - fr.start_ns;
+                const uint64_t excl = incl > fr.child_ns ? incl - fr.child_ns : 0;
+
+                Agg& a = lf.agg[fr.fn];
+                a.calls++;
+                a.incl_ns += incl;
+                a.excl_ns += excl;
+                if (incl > a.max_incl_ns) a.max_incl_ns = incl;
+
+                if (!stack.empty()) stack.back().child_ns += incl;
+                if (fr.fn == fn) break;
+            }
+            return true;
+        });
+}
+
+// ---- trace / flamegraph export --------------------------------------------
+
+struct ExportCtx {
+    FILE* trace = nullptr;                               // Chrome JSON (or null)
+    std::unordered_map<std::string, uint64_t>* folded = nullptr; // path → ns
+    uint64_t t0      = 0;                                // earliest event, ns
+    uint64_t win_lo  = 0;                                // absolute ns bounds
+    uint64_t win_hi  = UINT64_MAX;
+    bool     first   = true;                             // JSON comma state
+};
+
+std::string json_escape(const std::string& s) {
+    std::string t;
+    for (char c : s) {
+        if (c == '"' || c == '\\') t += '\\';
+        t += c;
+    }
+    return t;
+}
+
+// Re-walk one log emitting complete ("X") trace events and folded stacks
+// for every frame that overlaps the window.
+void export_log(const LogFile& lf, Symbolizer& sym, ExportCtx& ctx) {
+    LoadedLog log;
+    if (!log.open(lf.path)) return;
+
+    struct Frame { uintptr_t fn; uint64_t start_ns, child_ns; };
+    std::vector<Frame> stack;
+    stack.reserve(256);
+
+    uint32_t pid, tid;
+    (void)walk_records(log.data, log.size, pid, tid,
+        [&](uintptr_t fn, uint64_t ts_ns, int type) {
+            if (type == 0) {
+                stack.push_back({fn, ts_ns, 0});
+                return true;
+            }
+            while (!stack.empty()) {
+                Frame fr = stack.back();
+                stack.pop_back();
+
+                const uint64_t incl = ts_ns - fr.start_ns;
+                const uint64_t excl = incl > fr.child_ns ? incl - fr.child_ns : 0;
+                if (!stack.empty()) stack.back().child_ns += incl;
+
+                // clip to the window
+                if (ts_ns > ctx.win_lo && fr.start_ns < ctx.win_hi) {
+                    const std::string name = sym.resolve(fr.fn).second;
+
+                    if (ctx.trace) {
+                        fprintf(ctx.trace,
+                                "%s\n{\"name\":\"%s\",\"cat\":\"fprof\",\"ph\":\"X\","
+                                "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}",
+                                ctx.first ? "" : ",", json_escape(name).c_str(),
+                                (fr.start_ns - ctx.t0) / 1e3, incl / 1e3,
+                                lf.pid, lf.tid);
+                        ctx.first = false;
+                    }
+                    if (ctx.folded) {
+                        std::string path;
+                        for (const Frame& anc : stack)
+                            path += sym.resolve(anc.fn).second + ";";
+                        path += name;
+                        // accumulate ns: converting per frame truncates
+                        // sub-microsecond calls to zero, which is exactly
+                        // what hot short functions are made of
+                        (*ctx.folded)[path] += excl;
+                    }
+                }
+
+                if (fr.fn == fn) break;
+            }
+            return true;
+        });
+}
+
+// ---- CSV output (same columns as prof2.py) --------------------------------
+
+void write_csv(const std::string& path,
+               const std::unordered_map<uintptr_t, Agg>& agg, Symbolizer& sym) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) { fprintf(stderr, "cannot write %s\n", path.c_str()); return; }
+
+    std::vector<std::pair<uintptr_t, Agg>> rows(agg.begin(), agg.end());
+    std::sort(rows.begin(), rows.end(),
+              [](const auto& x, const auto& y) { return x.second.excl_ns > y.second.excl_ns; });
+
+    fprintf(out, "module,function,calls,total_inclusive_ns,total_exclusive_ns,"
+                 "avg_inclusive_ns,avg_exclusive_ns,max_inclusive_ns\n");
+    for (const auto& [fn, a] : rows) {
+        auto [module, name] = sym.resolve(fn);
+        auto esc = [](const std::string& s) {
+            if (s.find_first_of(",\"\n") == std::string::npos) return s;
+            std::string t = "\"";
+            for (char c : s) t += (c == '\"') ? "\"\"" : std::string(1, c);
+            return t += "\"";
+        };
+        fprintf(out, "%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.0f,%.0f,%" PRIu64 "\n",
+                esc(module).c_str(), esc(name).c_str(),
+                a.calls, a.incl_ns, a.excl_ns,
+                a.calls ? double(a.incl_ns) / a.calls : 0.0,
+                a.calls ? double(a.excl_ns) / a.calls : 0.0,
+                a.max_incl_ns);
+    }
+    fclose(out);
+    printf("Wrote: %s\n", path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string dir, prefix = "report", trace_path, folded_path;
+    bool per_thread = false;
+    uint64_t win_lo_ms = 0, win_hi_ms = UINT64_MAX;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--out-prefix" && i + 1 < argc) prefix = argv[++i];
+        else if (arg == "--per-thread") per_thread = true;
+        else if (arg == "--trace" && i + 1 < argc) trace_path = argv[++i];
+        else if (arg == "--folded" && i + 1 < argc) folded_path = argv[++i];
+        else if (arg == "--window" && i + 1 < argc) {
+            char* end = nullptr;
+            win_lo_ms = strtoull(argv[++i], &end, 10);
+            if (!end || *end != '-') { dir.clear(); break; }
+            win_hi_ms = strtoull(end + 1, nullptr, 10);
+        }
+        else if (dir.empty()) dir = arg;
+        else { dir.clear(); break; }
+    }
+    if (dir.empty() || win_lo_ms >= win_hi_ms) {
+        fprintf(stderr, "usage: %s <fprof-dir> [--out-prefix P] [--per-thread]\n"
+                        "       [--trace out.json] [--folded out.folded] [--window A-B]\n",
+                argv[0]);
+        return 1;
+    }
+
+    // collect <pid>.<tid>.bin files
+    std::vector<LogFile> logs;
+    if (DIR* d = opendir(dir.c_str())) {
+        while (dirent* e = readdir(d)) {
+            const std::string name = e->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0)
+                logs.push_back({dir + "/" + name});
+        }
+        closedir(d);
+    }
+    if (logs.empty()) {
+        fprintf(stderr, "no .bin logs in %s\n", dir.c_str());
+        return 1;
+    }
+
+    // aggregate each log on its own worker (bounded by the core count)
+    {
+        std::vector<std::jthread> workers;
+        const size_t lanes =
+            std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                             logs.size());
+        for (size_t w = 0; w < lanes; ++w)
+            workers.emplace_back([&, w] {
+                for (size_t i = w; i < logs.size(); i += lanes)
+                    if (!aggregate_log(logs[i]))
+                        fprintf(stderr, "skipping %s (bad header)\n",
+                                logs[i].path.c_str());
+            });
+    }
+
+    // merge per pid
+    std::unordered_map<uint32_t, std::unordered_map<uintptr_t, Agg>> by_pid;
+    for (const auto& lf : logs) {
+        if (lf.pid == 0) continue;
+        auto& dst = by_pid[lf.pid];
+        for (const auto& [fn, a] : lf.agg) {
+            Agg& d = dst[fn];
+            d.calls += a.calls;
+            d.incl_ns += a.incl_ns;
+            d.excl_ns += a.excl_ns;
+            d.max_incl_ns = std::max(d.max_incl_ns, a.max_incl_ns);
+        }
+    }
+
+    for (auto& [pid, agg] : by_pid) {
+        Symbolizer sym(dir, pid);
+        write_csv(prefix + "_pid_" + std::to_string(pid) + "_combined.csv", agg, sym);
+        if (per_thread)
+            for (auto& lf : logs)
+                if (lf.pid == pid)
+                    write_csv(prefix + "_pid_" + std::to_string(pid) + "_tid_"
+                                  + std::to_string(lf.tid) + ".csv",
+                              lf.agg, sym);
+    }
+
+    // trace / flamegraph exports (one pass per log, clipped to the window)
+    if (!trace_path.empty() || !folded_path.empty()) {
+        ExportCtx ctx;
+        ctx.t0 = UINT64_MAX;
+        for (const auto& lf : logs)
+            if (lf.pid != 0) {
+                // earliest event: the first record predates the header's
+                // start_ns (it is stamped before the lazy fd open)
+                LoadedLog m;
+                if (m.open(lf.path)) {
+                    const uint64_t ts = first_timestamp(m.data, m.size);
+                    if (ts) ctx.t0 = std::min(ctx.t0, ts);
+                }
+            }
+        if (ctx.t0 == UINT64_MAX) ctx.t0 = 0;
+        if (win_lo_ms) ctx.win_lo = ctx.t0 + win_lo_ms * 1000000;
+        if (win_hi_ms != UINT64_MAX) ctx.win_hi = ctx.t0 + win_hi_ms * 1000000;
+
+        std::unordered_map<std::string, uint64_t> folded;
+        if (!folded_path.empty()) ctx.folded = &folded;
+        if (!trace_path.empty()) {
+            ctx.trace = fopen(trace_path.c_str(), "w");
+            if (ctx.trace) fprintf(ctx.trace, "[");
+        }
+
+        for (auto& [pid, agg] : by_pid) {
+            (void)agg;
+            Symbolizer sym(dir, pid);
+            for (const auto& lf : logs)
+                if (lf.pid == pid) export_log(lf, sym, ctx);
+        }
+
+        if (ctx.trace) {
+            fprintf(ctx.trace, "\n]\n");
+            fclose(ctx.trace);
+            printf("Wrote: %s\n", trace_path.c_str());
+        }
+        if (ctx.folded) {
+            if (FILE* f = fopen(folded_path.c_str(), "w")) {
+                for (const auto& [path, ns] : folded) {
+                    const uint64_t us = (ns + 500) / 1000; // to us, rounded
+                    if (us) fprintf(f, "%s %" PRIu64 "\n", path.c_str(), us);
+                }
+                fclose(f);
+                printf("Wrote: %s\n", folded_path.c_str());
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+// fprof_lz.h
+// Tiny self-contained LZ4-block-format codec shared by the event logger
+// (instruments/profiling.cpp) and the native analyzer (analyze.cpp).
+// The enter/exit streams are extremely repetitive, so even this greedy
+// single-pass match finder gets large ratios at memory-bandwidth speed —
+// and the repo stays dependency-free.
+//
+// Wire format per block is standard LZ4: token byte (literal_len<<4 |
+// match_len-4, 15 = extended with 255-run bytes), literals, little-endian
+// u16 offset, minimum match 4, final 5+ bytes always literal.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace fprof_lz {
+
+namespace detail {
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t hash(uint32_t v) { return (v * 2654435761u) >> 20; } // 12 bit
+
+// Append a length with LZ4's 255-run extension; returns bytes written.
+inline size_t put_len(uint8_t* dst, size_t len) {
+    size_t n = 0;
+    while (len >= 255) { dst[n++] = 255; len -= 255; }
+    dst[n++] = static_cast<uint8_t>(len);
+    return n;
+}
+
+} // namespace detail
+
+// Compress src[0..n) into dst[0..cap).  Returns the compressed size, or 0
+// if the output would not fit (caller stores the block raw instead).
+inline size_t compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap)
+{
+    using namespace detail;
+
+    uint32_t table[4096] = {0};          // position + 1 of recent sequences
+
+    size_t ip = 0, anchor = 0, op = 0;
+
+    auto emit = [&](size_t lit_len, size_t match_len, size_t offset) -> bool {
+        // worst case: token + two extended lengths + literals + offset
+        if (op + 1 + lit_len / 255 + 1 + lit_len + 2 + match_len / 255 + 1 > cap)
+            return false;
+
+        const size_t tok = op++;
+        uint8_t token = 0;
+
+        if (lit_len >= 15) {
+            token = 15 << 4;
+            op += put_len(dst + op, lit_len - 15);
+        } else {
+            token = static_cast<uint8_t>(lit_len << 4);
+        }
+        memcpy(dst + op, src + anchor, lit_len);
+        op += lit_len;
+
+        if (match_len) {
+            dst[op++] = static_cast<uint8_t>(offset);
+            dst[op++] = static_cast<uint8_t>(offset >> 8);
+            const size_t m = match_len - 4;
+            if (m >= 15) {
+                token |= 15;
+                op += put_len(dst + op, m - 15);
+            } else {
+                token |= static_cast<uint8_t>(m);
+            }
+        }
+        dst[tok] = token;
+        return true;
+    };
+
+    if (n > 12) {
+        const size_t mflimit = n - 12;
+        while (ip < mflimit) {
+            const uint32_t seq = load32(src + ip);
+            const uint32_t h = hash(seq);
+            const size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+
+            if (ref != 0 && ip - (ref - 1) <= 65535 && load32(src + ref - 1) == seq) {
+                const size_t match = ref - 1;
+                size_t mlen = 4;
+                const size_t limit = n - 5;          // keep the literal tail
+                while (ip + mlen < limit && src[match + mlen] == src[ip + mlen])
+                    ++mlen;
+
+                if (!emit(ip - anchor, mlen, ip - match)) return 0;
+                ip += mlen;
+                anchor = ip;
+                continue;
+            }
+            ++ip;
+        }
+    }
+
+    if (!emit(n - anchor, 0, 0)) return 0;           // final literal run
+    return op;
+}
+
+// Decompress src[0..n) into dst[0..raw_len).  Returns false on malformed
+// or truncated input (never reads or writes out of bounds).
+inline bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_len)
+{
+    size_t ip = 0, op = 0;
+
+    auto get_len = [&](size_t base) -> size_t {
+        size_t len = base;
+        if (base == 15) {
+            uint8_t b;
+            do {
+                if (ip >= n) return SIZE_MAX;
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        return len;
+    };
+
+    while (ip < n) {
+        const uint8_t token = src[ip++];
+
+        size_t lit = get_len(token >> 4);
+        if (lit == SIZE_MAX || ip + lit > n || op + lit > raw_len) return false;
+        memcpy(dst + op, src + ip, lit);
+        ip += lit;
+        op += lit;
+
+        if (ip == n) break;                          // final literal run
+
+        if (ip + 2 > n) return false;
+        const size_t offset = src[ip] | (size_t(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        size_t mlen = get_len(token & 15);
+        if (mlen == SIZE_MAX) return false;
+        mlen += 4;
+        if (op + mlen > raw_len) return false;
+        for (size_t i = 0; i < mlen; ++i, ++op)      // overlap-safe copy
+            dst[op] = dst[op - offset];
+    }
+    return op == raw_len;
+}
+
+} // namespace fprof_lz
@@ -2,6 +2,7 @@
 // GNU/Linux + GCC, C++17+.
 
 #define _GNU_SOURCE
+#include <algorithm>
 #include <atomic>
 #include <cinttypes>
 #include <cstdint>
@@ -15,14 +16,51 @@
 #include <chrono>
 #include <dlfcn.h>          // dladdr
 #include <cxxabi.h>         // abi::__cxa_demangle
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
 
 // Mark all helpers as non-instrumented to avoid recursion.
 #define NOINST __attribute__((no_instrument_function))
 
+// --- config via env vars ---
+// FPROF_OUT: CSV report path (default: stderr)
+// FPROF_SAMPLE=N: aggregate only 1-in-N calls, scaling calls/incl/excl by N
+//                 (skips the per-call hash lookup for the other N-1, the
+//                 dominant distortion on tiny hot functions)
+// FPROF_MIN_NS=X: suppress aggregation of frames whose inclusive time is
+//                 below X ns (child time still flows to the parent)
+// FPROF_ADDR_RANGE=lo-hi: only aggregate functions whose address falls in
+//                 [lo, hi) (hex, e.g. 0x400000-0x500000)
+// FPROF_LIVE=N: snapshot the aggregates every N seconds (0 = only on
+//                 SIGUSR1) so long-lived daemons can be profiled without a
+//                 restart; either FPROF_LIVE or FPROF_LIVE_OUT enables it
+// FPROF_LIVE_OUT: snapshot path (default /tmp/fprof-live-<pid>.csv);
+//                 written to <path>.tmp then renamed, never torn
+static uint64_t  g_sample_n = 1;
+static uint64_t  g_min_ns   = 0;
+static uintptr_t g_addr_lo  = 0;
+static uintptr_t g_addr_hi  = UINTPTR_MAX;
+// FPROF_CALIBRATE=0: disable the startup hook-cost calibration.  By default
+//                 the cost of one enter+exit hook pair (clock reads, hash
+//                 lookup, stack push/pop) is measured at init and
+//                 2 × hook_cost × calls is subtracted into the corrected
+//                 report columns — a 30 ns function measures ~6x its true
+//                 cost otherwise, which breaks any comparison between
+//                 functions with different call counts.
+static uint64_t  g_hook_pair_ns   = 0;
+static int       g_live_mode      = 0;
+static uint64_t  g_live_period_ns = 0;
+static uint64_t  g_fold_period_ns = 0;
+static char      g_live_path[4096] = {0};
+static volatile sig_atomic_t g_snap_request = 0;
+
 struct NOINST Frame {
     void* fn;
     uint64_t start_ns;
     uint64_t child_ns;
+    uint32_t sampled;   // this call is one of the 1-in-N we aggregate
 };
 
 struct NOINST Agg {
@@ -36,15 +74,27 @@ struct NOINST ThreadData {
     std::vector<Frame> stack;
     std::unordered_map<void*, Agg> local;
     void flush_to_global();
-    ~ThreadData(); // defined below with NOINST
+    NOINST ~ThreadData(); // defined below
 };
 
-static std::mutex g_mu NOINST;
-static std::unordered_map<void*, Agg> g_stats NOINST;
+// Global aggregates are leaked-on-purpose singletons: the atexit report can
+// run after this TU's static destructors (init_prof's constructor runs
+// before g_stats' dynamic init would), so they must never be destroyed.
+static std::mutex& NOINST g_mu() {
+    static std::mutex* mu = new std::mutex;
+    return *mu;
+}
+static std::unordered_map<void*, Agg>& NOINST g_stats() {
+    static auto* stats = new std::unordered_map<void*, Agg>;
+    return *stats;
+}
 
 // Each thread accumulates locally (no locks on the hot path) and merges at exit.
 static thread_local ThreadData tdata;
-static thread_local int tls_guard NOINST = 0; // reentrancy guard
+static thread_local int tls_guard = 0;      // reentrancy guard
+static thread_local uint64_t tls_tick = 0;  // sampling counter
+static thread_local uint64_t tls_exit_tick    = 0; // live-mode fold pacing
+static thread_local uint64_t tls_last_fold_ns = 0;
 
 // --- util ---
 static inline uint64_t NOINST now_ns() {
@@ -54,9 +104,9 @@ static inline uint64_t NOINST now_ns() {
 
 void NOINST ThreadData::flush_to_global() {
     if (local.empty()) return;
-    std::lock_guard<std::mutex> lk(g_mu);
+    std::lock_guard<std::mutex> lk(g_mu());
     for (auto &kv : local) {
-        auto &dst = g_stats[kv.first];
+        auto &dst = g_stats()[kv.first];
         dst.calls       += kv.second.calls;
         dst.incl_ns     += kv.second.incl_ns;
         dst.excl_ns     += kv.second.excl_ns;
@@ -65,7 +115,7 @@ void NOINST ThreadData::flush_to_global() {
     local.clear();
 }
 
-ThreadData::~ThreadData() NOINST { flush_to_global(); }
+ThreadData::~ThreadData() { flush_to_global(); }
 
 // --- reporting ---
 struct NOINST Row {
@@ -99,26 +149,18 @@ static std::string NOINST addr_to_name(void* addr, std::string* module_out) {
     return buf;
 }
 
-static void NOINST write_report() {
-    // Ensure main thread data is merged.
-    tdata.flush_to_global();
-
+static void NOINST write_stats_csv(FILE* out) {
     // Snapshot + sort by total exclusive time.
     std::vector<Row> rows;
-    rows.reserve(g_stats.size());
+    rows.reserve(g_stats().size());
     {
-        std::lock_guard<std::mutex> lk(g_mu);
-        for (auto &kv : g_stats) rows.push_back({kv.first, kv.second});
+        std::lock_guard<std::mutex> lk(g_mu());
+        for (auto &kv : g_stats()) rows.push_back({kv.first, kv.second});
     }
     std::sort(rows.begin(), rows.end(),
               [](const Row& x, const Row& y) { return x.a.excl_ns > y.a.excl_ns; });
 
-    // Output: CSV to file or stderr
-    const char* path = std::getenv("FPROF_OUT");
-    FILE* out = path ? std::fopen(path, "w") : stderr;
-    if (!out) out = stderr;
-
-    std::fprintf(out, "module,function,calls,total_inclusive_ns,total_exclusive_ns,avg_inclusive_ns,avg_exclusive_ns,max_inclusive_ns\n");
+    std::fprintf(out, "module,function,calls,total_inclusive_ns,total_exclusive_ns,avg_inclusive_ns,avg_exclusive_ns,max_inclusive_ns,corr_inclusive_ns,corr_exclusive_ns\n");
 
     for (const auto& r : rows) {
         double avg_incl = r.a.calls ? (double)r.a.incl_ns / r.a.calls : 0.0;
@@ -134,17 +176,144 @@ static void NOINST write_report() {
             t += "\"";
             return t;
         };
-        std::fprintf(out, "%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.0f,%.0f,%" PRIu64 "\n",
+        // Corrected totals: each aggregated call paid one enter+exit hook
+        // pair of measurement overhead; clamp at zero for tiny functions.
+        const uint64_t overhead = g_hook_pair_ns * r.a.calls;
+        const uint64_t corr_incl = r.a.incl_ns > overhead ? r.a.incl_ns - overhead : 0;
+        const uint64_t corr_excl = r.a.excl_ns > overhead ? r.a.excl_ns - overhead : 0;
+        std::fprintf(out, "%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.0f,%.0f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
                      esc(module).c_str(), esc(name).c_str(),
                      r.a.calls, r.a.incl_ns, r.a.excl_ns,
-                     avg_incl, avg_excl, r.a.max_incl_ns);
+                     avg_incl, avg_excl, r.a.max_incl_ns,
+                     corr_incl, corr_excl);
     }
+}
+
+static void NOINST write_report() {
+    // Ensure main thread data is merged.
+    tdata.flush_to_global();
+
+    // Output: CSV to file or stderr
+    const char* path = std::getenv("FPROF_OUT");
+    FILE* out = path ? std::fopen(path, "w") : stderr;
+    if (!out) out = stderr;
+    write_stats_csv(out);
     if (out != stderr) std::fclose(out);
 }
 
+// --- live mode ---
+// Snapshots go to <path>.tmp first and are renamed into place, so an
+// external reader never sees a torn file.  Worker threads fold their local
+// maps into the global one on a timer (see the exit hook), so a snapshot
+// is at most a couple of seconds stale.
+static void NOINST write_snapshot() {
+    char tmp[sizeof g_live_path + 8];
+    std::snprintf(tmp, sizeof tmp, "%s.tmp", g_live_path);
+    FILE* out = std::fopen(tmp, "w");
+    if (!out) return;
+    write_stats_csv(out);
+    std::fclose(out);
+    (void)std::rename(tmp, g_live_path);
+}
+
+static void NOINST on_sigusr1(int) { g_snap_request = 1; }
+
+static void* NOINST live_thread_main(void*) {
+    uint64_t last = now_ns();
+    for (;;) {
+        struct timespec ts = {0, 100 * 1000 * 1000}; // 100 ms tick
+        nanosleep(&ts, nullptr);
+        const bool due =
+            g_live_period_ns && (now_ns() - last) >= g_live_period_ns;
+        if (g_snap_request || due) {
+            g_snap_request = 0;
+            last = now_ns();
+            write_snapshot();
+        }
+    }
+    return nullptr;
+}
+
+// Measure what one enter+exit hook pair costs on this machine by driving
+// the real hooks against a probe address, then scrub the probe from the
+// aggregates.  Runs with the configured sampling/filter settings, so the
+// measured cost matches what real calls actually pay.
+static void NOINST calibrate_hooks() {
+    static char probe_anchor;                  // unique non-function address
+    void* probe = &probe_anchor;
+    constexpr int kWarmup = 1000, kIters = 100000;
+
+    for (int i = 0; i < kWarmup; ++i) {
+        __cyg_profile_func_enter(probe, nullptr);
+        __cyg_profile_func_exit(probe, nullptr);
+    }
+    const uint64_t t0 = now_ns();
+    for (int i = 0; i < kIters; ++i) {
+        __cyg_profile_func_enter(probe, nullptr);
+        __cyg_profile_func_exit(probe, nullptr);
+    }
+    const uint64_t t1 = now_ns();
+    g_hook_pair_ns = (t1 - t0) / kIters;
+
+    tdata.local.erase(probe);
+    {
+        std::lock_guard<std::mutex> lk(g_mu());
+        g_stats().erase(probe);
+    }
+}
+
 // Register report at process exit.
-static void NOINST at_exit_report() { write_report(); }
+static void NOINST at_exit_report() {
+    if (g_hook_pair_ns)
+        std::fprintf(stderr, "fprof: hook pair cost ~%" PRIu64 " ns/call; "
+                             "corr_* columns subtract it\n", g_hook_pair_ns);
+    write_report();
+}
 __attribute__((constructor)) static void NOINST init_prof() {
+    if (const char* s = std::getenv("FPROF_SAMPLE")) {
+        g_sample_n = std::strtoull(s, nullptr, 10);
+        if (g_sample_n == 0) g_sample_n = 1;
+    }
+    if (const char* s = std::getenv("FPROF_MIN_NS"))
+        g_min_ns = std::strtoull(s, nullptr, 10);
+    if (const char* s = std::getenv("FPROF_ADDR_RANGE")) {
+        char* end = nullptr;
+        const uintptr_t lo = (uintptr_t)std::strtoull(s, &end, 16);
+        if (end && *end == '-') {
+            const uintptr_t hi = (uintptr_t)std::strtoull(end + 1, nullptr, 16);
+            if (hi > lo) { g_addr_lo = lo; g_addr_hi = hi; }
+        }
+    }
+    if (const char* s = std::getenv("FPROF_LIVE")) {
+        g_live_mode = 1;
+        g_live_period_ns = std::strtoull(s, nullptr, 10) * 1000000000ull;
+    }
+    if (const char* s = std::getenv("FPROF_LIVE_OUT")) {
+        g_live_mode = 1;
+        std::snprintf(g_live_path, sizeof g_live_path, "%s", s);
+    }
+    if (g_live_mode) {
+        if (!g_live_path[0])
+            std::snprintf(g_live_path, sizeof g_live_path,
+                          "/tmp/fprof-live-%u.csv", (unsigned)getpid());
+        // Fold thread-locals at least once a second (or faster, matching a
+        // shorter snapshot period) so snapshots stay fresh.
+        g_fold_period_ns = 1000000000ull;
+        if (g_live_period_ns && g_live_period_ns < g_fold_period_ns)
+            g_fold_period_ns = g_live_period_ns;
+
+        struct sigaction sa{};
+        sa.sa_handler = on_sigusr1;
+        sigaction(SIGUSR1, &sa, nullptr);
+
+        pthread_t tid;
+        if (pthread_create(&tid, nullptr, live_thread_main, nullptr) == 0)
+            pthread_detach(tid);
+    }
+
+    const char* calib = std::getenv("FPROF_CALIBRATE");
+    if (!calib || calib[0] != '0') calibrate_hooks();
+
     std::atexit(at_exit_report); // atexit handler is non-instrumented (NOINST)
 }
 
@@ -156,7 +325,11 @@ extern "C" void __cyg_profile_func_exit (void* this_fn, void* /*call_site*/) NOI
 extern "C" void NOINST __cyg_profile_func_enter(void* this_fn, void*) {
     if (++tls_guard != 1) { --tls_guard; return; }
     uint64_t t = now_ns();
-    tdata.stack.push_back(Frame{this_fn, t, 0});
+    // Frames are always pushed (the stack must stay balanced); sampling
+    // just decides which calls pay for aggregation on exit.
+    const uint32_t sampled =
+        (g_sample_n <= 1) || (++tls_tick % g_sample_n == 0);
+    tdata.stack.push_back(Frame{this_fn, t, 0, sampled});
     --tls_guard;
 }
 
@@ -176,17 +349,31 @@ extern "C" void NOINST __cyg_profile_func_exit(void* this_fn, void*) {
         uint64_t incl = t - fr.start_ns;
         uint64_t excl = (incl > fr.child_ns) ? (incl - fr.child_ns) : 0;
 
-        Agg& a = tdata.local[fr.fn];
-        a.calls++;
-        a.incl_ns += incl;
-        a.excl_ns += excl;
-        if (incl > a.max_incl_ns) a.max_incl_ns = incl;
+        // Aggregate only sampled frames that pass the filters; totals are
+        // scaled by the sampling factor so they stay estimates of the truth.
+        if (fr.sampled && incl >= g_min_ns &&
+            (uintptr_t)fr.fn >= g_addr_lo && (uintptr_t)fr.fn < g_addr_hi) {
+            Agg& a = tdata.local[fr.fn];
+            a.calls   += g_sample_n;
+            a.incl_ns += incl * g_sample_n;
+            a.excl_ns += excl * g_sample_n;
+            if (incl > a.max_incl_ns) a.max_incl_ns = incl;
+        }
 
         // Attribute inclusive time to parent as "child time".
         if (!tdata.stack.empty()) {
             tdata.stack.back().child_ns += incl;
         }
 
+        // Live mode: fold this thread's aggregates into the global map on a
+        // timer (checked cheaply) so snapshots are never more than a fold
+        // period stale.
+        if (g_live_mode && (++tls_exit_tick & 4095) == 0 &&
+            t - tls_last_fold_ns >= g_fold_period_ns) {
+            tdata.flush_to_global();
+            tls_last_fold_ns = t;
+        }
+
         if (fr.fn == this_fn) break; // normal case; or we caught up after unwind
         // else: keep draining until we reconcile the stack.
     }
@@ -140,6 +140,10 @@ def load_header(mm: mmap.mmap) -> Tuple[int, int, int, int]:
     if len(hdr) != HEADER_SZ:
         raise RuntimeError("bad header length")
     magic, pid, tid, start_ns, rec_size, flags = struct.unpack(HEADER_FMT, hdr)
+    if flags & 4:
+        raise RuntimeError("LZ-compressed log (FPROF_COMPRESS=1): decode with the native analyzer (instruments/analyze.cpp)")
+    if magic[:7] == b"FPROFv2":
+        raise RuntimeError("FPROFv2 compact log: decode with the native analyzer (instruments/analyze.cpp)")
     if magic[:7] != b"FPROFv1":
         raise RuntimeError("bad magic in {}".format(magic))
     if rec_size != RECORD_SZ:
@@ -5,6 +5,12 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <unistd.h>
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include <x86intrin.h>      // __rdtsc
+
+#include "fprof_lz.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -26,9 +32,34 @@
 // --- config via env vars ---
 // FPROF_DIR: directory for logs (default: /tmp/fprof-<pid>)
 // FPROF_UNBUFFERED=1: disable TLS buffer (one write() per event; slower but truly no buffering)
+// FPROF_RING=1: route records through per-thread lock-free SPSC rings drained
+//               by a background thread, so the instrumented hot path never
+//               touches a syscall (flush() write stalls otherwise land in
+//               exactly the threads being measured)
+// FPROF_RING_POLICY=drop|block: what a producer does when its ring is full -
+//               drop (default) counts and discards; block spins until the
+//               drainer catches up
+// FPROF_COMPACT=1: FPROFv2 logs - rdtsc timestamps (calibrated once against
+//               the monotonic clock, conversion recorded in the header) and
+//               a compact encoding: per-thread function table, varint
+//               function indices and varint tsc deltas, ~4-6 bytes/event
+//               instead of 24. The timer itself also gets much cheaper.
+//               Ring mode keeps fixed-size records; if both are set, the
+//               ring wins and compact is disabled.
 static char g_dir[PATH_MAX] = {0};
 static pid_t g_pid = 0;
 static int   g_unbuffered = 0;
+static int   g_ring_mode  = 0;
+static int   g_ring_block = 0;
+// FPROF_COMPRESS=1: LZ-compress each flushed buffer before write() (see
+//               fprof_lz.h), framed as [u32 comp_len][u32 raw_len][bytes]
+//               with comp_len 0 meaning stored raw; header flags bit2 set.
+//               The enter/exit streams compress ~10-20x, so disk stops
+//               being the limit on soak-test duration.  Ignored with
+//               FPROF_UNBUFFERED (no buffer to compress).
+static int   g_compact    = 0;
+static uint64_t g_tsc_per_sec = 0;
+static int   g_compress   = 0;
 
 static inline uint64_t NOINST now_ns() {
     struct timespec ts;
@@ -103,6 +134,138 @@ struct NOINST Record {
 } __attribute__((packed));
 static_assert(sizeof(Record) == 24, "Record size must be 24 bytes");
 
+// FPROFv2 header: v1 header (magic "FPROFv2", rec_size 0, flags bit1 set)
+// followed by the tsc→ns conversion.  The byte stream after it is:
+//   0x00 <8-byte fn pointer>            define next function-table index
+//   varint((idx+1)<<1 | type) varint(delta_tsc)   one event
+struct NOINST LogHeaderV2 {
+    LogHeader base;
+    uint64_t  tsc_per_sec;
+    uint64_t  start_tsc;     // delta base for the first event
+};
+
+// Ratio of rdtsc ticks to CLOCK_MONOTONIC_RAW ns, sampled over 10 ms.
+static uint64_t NOINST calibrate_tsc() {
+    const uint64_t t0 = now_ns();
+    const uint64_t c0 = __rdtsc();
+    struct timespec ts = {0, 10 * 1000 * 1000};
+    nanosleep(&ts, nullptr);
+    const uint64_t t1 = now_ns();
+    const uint64_t c1 = __rdtsc();
+    if (t1 <= t0 || c1 <= c0) return 0;
+    return (c1 - c0) * 1000000000ull / (t1 - t0);
+}
+
+static size_t NOINST put_varint(unsigned char* out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) { out[n++] = (unsigned char)(v | 0x80); v >>= 7; }
+    out[n++] = (unsigned char)v;
+    return n;
+}
+
+// --- lock-free SPSC ring mode (FPROF_RING=1) ---
+// One ring per instrumented thread (single producer), one global drainer
+// thread (single consumer) that batches contiguous spans to each ring's fd.
+struct NOINST RingBuffer {
+    enum { CAP = 1 << 16 };                 // records; ~1.5 MiB per thread
+    Record slots[CAP];
+    std::atomic<uint32_t> head{0};          // consumer position
+    std::atomic<uint32_t> tail{0};          // producer position
+    std::atomic<uint64_t> dropped{0};       // ring-full discards (drop policy)
+    std::atomic<int>      done{0};          // producer thread exited
+    int                   fd     = -1;
+    int                   closed = 0;       // drainer-local
+};
+
+enum { MAX_RINGS = 1024 };
+static std::atomic<RingBuffer*> g_rings[MAX_RINGS];
+static std::atomic<int>  g_ring_slots{0};
+static std::atomic<int>  g_drainer_started{0};
+static std::atomic<int>  g_drainer_stop{0};
+static pthread_t         g_drainer;
+
+static void NOINST write_lz_frame(int fd, const unsigned char* raw, size_t raw_len,
+                                  unsigned char* scratch, size_t scratch_cap);
+
+// Drain whatever the producer has published; close the fd once the
+// producer is gone and the ring is empty.
+static void NOINST drain_ring(RingBuffer* r) {
+    uint32_t       head = r->head.load(std::memory_order_relaxed);
+    const uint32_t tail = r->tail.load(std::memory_order_acquire);
+    // drainer-only scratch for the compressed path (single consumer)
+    enum { SPAN_CAP = 64 * 1024 };
+    static unsigned char lz_scratch[SPAN_CAP + SPAN_CAP / 200 + 64];
+
+    while (head != tail) {
+        const uint32_t idx = head % (uint32_t)RingBuffer::CAP;
+        uint32_t n = tail - head;
+        if (n > (uint32_t)RingBuffer::CAP - idx) n = (uint32_t)RingBuffer::CAP - idx;
+        if (g_compress) {
+            if (n > SPAN_CAP / sizeof(Record)) n = SPAN_CAP / sizeof(Record);
+            write_lz_frame(r->fd, (const unsigned char*)&r->slots[idx],
+                           (size_t)n * sizeof(Record), lz_scratch, sizeof lz_scratch);
+        } else {
+            (void)full_write(r->fd, &r->slots[idx], (size_t)n * sizeof(Record));
+        }
+        head += n;
+        r->head.store(head, std::memory_order_release);
+    }
+    // Close only when the producer is gone AND nothing was published after
+    // the tail we just drained to — the done flag is release-stored after
+    // the producer's final records, so a fresh tail load is authoritative.
+    if (r->done.load(std::memory_order_acquire) && !r->closed &&
+        r->head.load(std::memory_order_relaxed) ==
+            r->tail.load(std::memory_order_acquire)) {
+        if (r->fd >= 0) close(r->fd);
+        r->closed = 1;
+    }
+}
+
+static void* NOINST drainer_main(void*) {
+    for (;;) {
+        const int stopping = g_drainer_stop.load(std::memory_order_acquire);
+        const int n = g_ring_slots.load(std::memory_order_acquire);
+        for (int i = 0; i < n && i < MAX_RINGS; ++i) {
+            RingBuffer* r = g_rings[i].load(std::memory_order_acquire);
+            if (r) drain_ring(r);
+        }
+        if (stopping) break;                 // one final pass above
+        struct timespec ts = {0, 2 * 1000 * 1000}; // 2 ms
+        nanosleep(&ts, nullptr);
+    }
+    return nullptr;
+}
+
+static void NOINST register_ring(RingBuffer* r) {
+    const int i = g_ring_slots.fetch_add(1, std::memory_order_acq_rel);
+    if (i < MAX_RINGS) g_rings[i].store(r, std::memory_order_release);
+    int expected = 0;
+    if (g_drainer_started.compare_exchange_strong(expected, 1))
+        pthread_create(&g_drainer, nullptr, drainer_main, nullptr);
+}
+
+// Final flush at process exit: stop the drainer (it drains once more on the
+// way out), close leftovers, and report drops so silent loss is visible.
+__attribute__((destructor))
+static void NOINST fprof_ring_shutdown() {
+    if (!g_drainer_started.load(std::memory_order_acquire)) return;
+    g_drainer_stop.store(1, std::memory_order_release);
+    pthread_join(g_drainer, nullptr);
+    uint64_t dropped = 0;
+    const int n = g_ring_slots.load(std::memory_order_acquire);
+    for (int i = 0; i < n && i < MAX_RINGS; ++i) {
+        RingBuffer* r = g_rings[i].load(std::memory_order_acquire);
+        if (!r) continue;
+        r->done.store(1, std::memory_order_release);
+        drain_ring(r);                       // main thread may not have exited
+        dropped += r->dropped.load(std::memory_order_relaxed);
+    }
+    if (dropped)
+        fprintf(stderr, "fprof: dropped %llu records (rings full; "
+                        "try FPROF_RING_POLICY=block)\n",
+                (unsigned long long)dropped);
+}
+
 // --- TLS logger per thread ---
 struct NOINST ThreadLogger {
     int      fd;
@@ -110,33 +273,57 @@ struct NOINST ThreadLogger {
     pid_t    tid;
     uint64_t opened_ns;
     enum { BUF_CAP = 64 * 1024 }; // per-thread buffer (set FPROF_UNBUFFERED=1 to disable)
+    enum { CBUF_CAP = BUF_CAP + BUF_CAP / 200 + 64 }; // compress worst case
     alignas(8) unsigned char buf[BUF_CAP];
+    alignas(8) unsigned char cbuf[CBUF_CAP];          // compressed frame
     int      initialized;
     int      disabled;
+    RingBuffer* ring;                 // non-null in FPROF_RING mode
+
+    // compact-mode state: open-addressed fn→index table + delta base
+    enum { FN_TABLE = 8192 };         // power of two
+    uintptr_t fn_slot[FN_TABLE];
+    uint32_t  fn_idx[FN_TABLE];
+    uint32_t  fn_count;
+    uint64_t  last_tsc;
 
     void ensure_init();
     void write_header();
     void flush();
     void append(const Record& r);
-    ~ThreadLogger();
+    void ring_append(const Record& r);
+    void append_compact(uintptr_t fn, int type);
+    void emit(const void* p, size_t len);
+    NOINST ~ThreadLogger();
 };
 
 static thread_local ThreadLogger tlog;
-static thread_local int tls_guard NOINST = 0;
+static thread_local int tls_guard = 0; // plain data: NOINST applies to functions only
 
 // --- Implementation ---
 void NOINST ThreadLogger::write_header() {
     LogHeader h{};
-    memcpy(h.magic, "FPROFv1", 8);
+    memcpy(h.magic, g_compact ? "FPROFv2" : "FPROFv1", 8);
     h.pid = (uint32_t)g_pid;
     h.tid = (uint32_t)tid;
     h.start_ns = opened_ns;
-    h.rec_size = (uint32_t)sizeof(Record);
+    h.rec_size = g_compact ? 0u : (uint32_t)sizeof(Record);
 #ifdef CLOCK_MONOTONIC_RAW
     h.flags = 1u; // bit0 = MONOTONIC_RAW
 #else
     h.flags = 0u;
 #endif
+    if (g_compress) h.flags |= 4u; // bit2 = LZ-framed payload
+    if (g_compact) {
+        h.flags |= 2u; // bit1 = compact encoding
+        LogHeaderV2 h2{};
+        h2.base        = h;
+        h2.tsc_per_sec = g_tsc_per_sec;
+        h2.start_tsc   = __rdtsc();
+        last_tsc = h2.start_tsc;
+        (void)full_write(fd, &h2, sizeof h2);
+        return;
+    }
     (void)full_write(fd, &h, sizeof h);
 }
 
@@ -156,21 +343,101 @@ void NOINST ThreadLogger::ensure_init() {
     pos = 0;
     opened_ns = now_ns();
     write_header();
+    if (g_ring_mode) {
+        ring = new RingBuffer();      // leaked on purpose: drainer keeps using it
+        ring->fd = fd;
+        register_ring(ring);
+    }
     initialized = 1;
 }
 
+// Write one LZ frame: [u32 comp_len][u32 raw_len][bytes]; comp_len 0 means
+// the payload is stored raw (incompressible block).
+static void NOINST write_lz_frame(int fd, const unsigned char* raw, size_t raw_len,
+                                  unsigned char* scratch, size_t scratch_cap) {
+    uint32_t head[2];
+    const size_t c = fprof_lz::compress(raw, raw_len, scratch, scratch_cap);
+    head[0] = (uint32_t)((c && c < raw_len) ? c : 0);
+    head[1] = (uint32_t)raw_len;
+    (void)full_write(fd, head, sizeof head);
+    if (head[0]) (void)full_write(fd, scratch, c);
+    else         (void)full_write(fd, raw, raw_len);
+}
+
 void NOINST ThreadLogger::flush() {
     if (disabled || !initialized) return;
     if (pos == 0) return;
-    (void)full_write(fd, buf, pos);
+    if (g_compress) write_lz_frame(fd, buf, pos, cbuf, sizeof cbuf);
+    else            (void)full_write(fd, buf, pos);
     pos = 0;
 }
 
+// Producer side of the SPSC ring: no locks, no syscalls
+void NOINST ThreadLogger::ring_append(const Record& r) {
+    const uint32_t t = ring->tail.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint32_t h = ring->head.load(std::memory_order_acquire);
+        if (t - h < (uint32_t)RingBuffer::CAP) break;       // room
+        if (!g_ring_block) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sched_yield();                 // block policy: wait for the drainer
+    }
+    ring->slots[t % (uint32_t)RingBuffer::CAP] = r;
+    ring->tail.store(t + 1, std::memory_order_release);
+}
+
+// Raw byte emit through the TLS buffer (compact mode)
+void NOINST ThreadLogger::emit(const void* p, size_t len) {
+    if (g_unbuffered) { (void)full_write(fd, p, len); return; }
+    if (pos + len > BUF_CAP) flush();
+    memcpy(buf + pos, p, len);
+    pos += len;
+}
+
+void NOINST ThreadLogger::append_compact(uintptr_t fn, int type) {
+    if (disabled) return;
+    if (!initialized) ensure_init();   // before rdtsc: header sets the base
+    if (disabled || fd < 0) return;
+
+    const uint64_t tsc = __rdtsc();
+
+    // find-or-define the function's table index
+    uint32_t idx   = 0;
+    size_t   slot  = (fn >> 4) & (FN_TABLE - 1);
+    size_t   probe = 0;
+    for (;; slot = (slot + 1) & (FN_TABLE - 1), ++probe) {
+        if (fn_slot[slot] == fn) { idx = fn_idx[slot]; break; }
+        if (fn_slot[slot] == 0 || probe == FN_TABLE) {
+            // new function (or table full: burn an index, stay correct)
+            idx = fn_count++;
+            if (probe != FN_TABLE) { fn_slot[slot] = fn; fn_idx[slot] = idx; }
+            unsigned char def[1 + sizeof fn];
+            def[0] = 0;
+            memcpy(def + 1, &fn, sizeof fn);
+            emit(def, sizeof def);
+            break;
+        }
+    }
+
+    unsigned char rec[20];
+    size_t n = put_varint(rec, ((uint64_t)(idx + 1) << 1) | (uint64_t)type);
+    n += put_varint(rec + n, tsc - last_tsc);
+    last_tsc = tsc;
+    emit(rec, n);
+}
+
 void NOINST ThreadLogger::append(const Record& r) {
     if (disabled) return;
     if (!initialized) ensure_init();
     if (disabled || fd < 0) return;
 
+    if (ring) {
+        ring_append(r);
+        return;
+    }
+
     if (g_unbuffered) {
         (void)full_write(fd, &r, sizeof r);
         return;
@@ -181,8 +448,13 @@ void NOINST ThreadLogger::append(const Record& r) {
     pos += sizeof(Record);
 }
 
-ThreadLogger::~ThreadLogger() NOINST {
+ThreadLogger::~ThreadLogger() {
     if (initialized && !disabled) {
+        if (ring) {
+            // Drainer flushes the leftovers and closes the fd
+            ring->done.store(1, std::memory_order_release);
+            return;
+        }
         flush();
         if (fd >= 0) close(fd);
     }
@@ -206,6 +478,21 @@ static void NOINST fprof_init() {
     const char* env_unbuf = getenv("FPROF_UNBUFFERED");
     g_unbuffered = (env_unbuf && env_unbuf[0] == '1') ? 1 : 0;
 
+    const char* env_ring = getenv("FPROF_RING");
+    g_ring_mode = (env_ring && env_ring[0] == '1') ? 1 : 0;
+    const char* env_policy = getenv("FPROF_RING_POLICY");
+    g_ring_block = (env_policy && strcmp(env_policy, "block") == 0) ? 1 : 0;
+
+    const char* env_compress = getenv("FPROF_COMPRESS");
+    g_compress = (env_compress && env_compress[0] == '1' && !g_unbuffered) ? 1 : 0;
+
+    const char* env_compact = getenv("FPROF_COMPACT");
+    g_compact = (env_compact && env_compact[0] == '1' && !g_ring_mode) ? 1 : 0;
+    if (g_compact) {
+        g_tsc_per_sec = calibrate_tsc();
+        if (!g_tsc_per_sec) g_compact = 0;   // no usable tsc: stay on v1
+    }
+
     // Save /proc/self/maps for the analyzer (address -> module resolution).
     char maps_path[PATH_MAX], cmd_path[PATH_MAX], exe_path[PATH_MAX], exe_out[PATH_MAX];
     snprintf(maps_path, sizeof maps_path, "%s/%u.maps", g_dir, (unsigned)g_pid);
@@ -227,6 +514,11 @@ extern "C" void __cyg_profile_func_exit (void* this_fn, void* call_site) NOINST;
 
 extern "C" void NOINST __cyg_profile_func_enter(void* this_fn, void*) {
     if (++tls_guard != 1) { --tls_guard; return; }
+    if (g_compact) {
+        tlog.append_compact((uintptr_t)this_fn, 0);
+        --tls_guard;
+        return;
+    }
     Record rec;
     rec.ts_ns = now_ns();
     rec.fn    = (uintptr_t)this_fn;
@@ -237,6 +529,11 @@ extern "C" void NOINST __cyg_profile_func_enter(void* this_fn, void*) {
 
 extern "C" void NOINST __cyg_profile_func_exit(void* this_fn, void*) {
     if (++tls_guard != 1) { --tls_guard; return; }
+    if (g_compact) {
+        tlog.append_compact((uintptr_t)this_fn, 1);
+        --tls_guard;
+        return;
+    }
     Record rec;
     rec.ts_ns = now_ns();
     rec.fn    = (uintptr_t)this_fn;